@@ -4,8 +4,9 @@
 #include <sbml/SBMLTypes.h>
 #include <string>
 #include "sbmlsim/config/RunConfiguration.h"
-#include "sbmlsim/internal/wrapper/ModelWrapper.h"
+#include "sbmlsim/Simulator.h"
 
+// one-shot runs; use Simulator to run a model more than once
 class SBMLSim {
  public:
   static void simulate(const std::string &filepath, const RunConfiguration &conf);
@@ -13,12 +14,6 @@ class SBMLSim {
  private:
   SBMLSim() {}
   ~SBMLSim() {}
-  static void simulate(const Model *model, unsigned int level, unsigned int version, const RunConfiguration &conf);
-  static void simulateRungeKutta4(const ModelWrapper *model, const RunConfiguration &conf);
-  static void simulateRungeKuttaDopri5(const ModelWrapper *model, const RunConfiguration &conf);
-  static void simulateRungeKuttaFehlberg78(const ModelWrapper *model, const RunConfiguration &conf);
-  static void simulateRosenbrock4(const ModelWrapper *model, const RunConfiguration &conf);
-  static void simulateLSODA(const ModelWrapper *model, const RunConfiguration &conf);
 };
 
 #endif /* INCLUDE_SBMLSIM_SBMLSIM_H_ */
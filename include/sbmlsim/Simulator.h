@@ -0,0 +1,91 @@
+#ifndef INCLUDE_SBMLSIM_SIMULATOR_H_
+#define INCLUDE_SBMLSIM_SIMULATOR_H_
+
+#include <sbml/SBMLTypes.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "sbmlsim/config/RunConfiguration.h"
+#include "sbmlsim/internal/system/SBMLSystem.h"
+#include "sbmlsim/internal/wrapper/ModelWrapper.h"
+
+/*
+ * A model read, wrapped and compiled once, for any number of runs. Each run
+ * works on its own copy of the compiled SBMLSystem (the bytecode and the
+ * stoichiometry are shared, not copied), so run() is const and concurrent
+ * runs on one Simulator are safe. Copies of a Simulator share the model.
+ * A run may override values by slot (see getSlot()); that costs O(number
+ * of overrides) on top of the copy, with no re-reading or re-compiling.
+ * sweep() runs a whole matrix of overrides, one run per row, in parallel;
+ * ensemble() runs independent stochastic trajectories in parallel.
+ */
+class Simulator {
+ public:
+  // time and the values of the run's output fields (in order) at each output point
+  using Observer = std::function<void(double, const std::vector<double> &)>;
+  // slot and value
+  using Override = std::pair<unsigned int, double>;
+  // row, then as Observer
+  using SweepObserver = std::function<void(unsigned long, double, const std::vector<double> &)>;
+  // trajectory, then as Observer
+  using EnsembleObserver = std::function<void(unsigned long, double, const std::vector<double> &)>;
+ public:
+  explicit Simulator(const std::string &filepath);
+  explicit Simulator(const SBMLDocument *document);
+  Simulator(const Simulator &simulator);
+  ~Simulator();
+  // CSV on stdout, as SBMLSim::simulate()
+  void run(const RunConfiguration &conf) const;
+  void run(const RunConfiguration &conf, const Observer &observer) const;
+  void run(const RunConfiguration &conf, const std::vector<Override> &overrides) const;
+  void run(const RunConfiguration &conf, const std::vector<Override> &overrides, const Observer &observer) const;
+  // slot of a global parameter, compartment or species (its initial amount), or of a reaction-local
+  // parameter given as "reactionId.parameterId"; values computed by initial assignments or rules win
+  unsigned int getSlot(const std::string &id) const;
+  /*
+   * One run per row of `values` (row-major, slots.size() columns): row r sets slots[k] to
+   * values[r * slots.size() + k]. Rows are spread over numThreads threads (0: one per hardware
+   * thread) by a WorkStealingScheduler, so a few slow (e.g. stiff) rows do not hold up the others.
+   * The observer is called from the worker threads concurrently; the calls for one row come in
+   * time order from one thread. Stochastic runs all use conf's seed. Fixed-step RK4 runs of a model
+   * without events go in lockstep batches of BATCH_NUM_LANES rows (SBMLSystemBatch), evaluating
+   * each expression for the whole batch at once. Returns the number of rows.
+   */
+  unsigned long sweep(const RunConfiguration &conf, const std::vector<unsigned int> &slots,
+                      const std::vector<double> &values, unsigned int numThreads,
+                      const SweepObserver &observer) const;
+  // as above, into results[(row * getNumOutputPoints(conf) + point) * conf.getOutputFields().size() + field],
+  // preallocated by the caller
+  unsigned long sweep(const RunConfiguration &conf, const std::vector<unsigned int> &slots,
+                      const std::vector<double> &values, unsigned int numThreads, double *results) const;
+  /*
+   * numTrajectories runs of conf's stochastic integrator on numThreads threads (0: one per hardware
+   * thread; see integrate_ensemble()). Trajectory k draws from PhiloxEngine(conf.getSeed(), k), so
+   * it comes out the same for any thread count. The observer is called from the worker threads
+   * concurrently; the calls for one trajectory come in time order from one thread. Returns the
+   * number of reaction firings over all trajectories.
+   */
+  unsigned long ensemble(const RunConfiguration &conf, unsigned long numTrajectories, unsigned int numThreads,
+                         const EnsembleObserver &observer) const;
+  // output points of a run: start, start + stepInterval, ... up to the end time (conf.getDuration())
+  static unsigned long getNumOutputPoints(const RunConfiguration &conf);
+ private:
+  // destroyed in reverse order: the system reads the wrappers, the wrappers read the document
+  std::shared_ptr<SBMLDocument> document;
+  std::shared_ptr<ModelWrapper> model;
+  std::shared_ptr<const SBMLSystem> system;
+  void compile();
+  SBMLSystem createSystem(const std::vector<Override> &overrides) const;
+  static std::vector<Override> createOverrides(const std::vector<unsigned int> &slots,
+                                               const std::vector<double> &values, unsigned long row);
+  void sweepBatch(const RunConfiguration &conf, const std::vector<unsigned int> &slots,
+                  const std::vector<double> &values, unsigned long firstRow, unsigned int numLanes,
+                  const SweepObserver &observer) const;
+  static void checkIntegrator(const SBMLSystem &system, IntegratorType integrator);
+  template<class RunObserver>
+  static void integrate(SBMLSystem &system, const RunConfiguration &conf, RunObserver &observer);
+};
+
+#endif /* INCLUDE_SBMLSIM_SIMULATOR_H_ */
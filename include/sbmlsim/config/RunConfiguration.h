@@ -2,9 +2,23 @@
 #define INCLUDE_SBMLSIM_CONFIG_RUNCONFIGURATION_H_
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "sbmlsim/config/OutputField.h"
 
+enum class IntegratorType {
+  RUNGE_KUTTA_4,
+  RUNGE_KUTTA_DOPRI5,
+  RUNGE_KUTTA_FEHLBERG78,
+  ROSENBROCK4,
+  LSODA,
+  AUTO,  // explicit until the problem turns stiff, implicit from then on
+  GILLESPIE_DIRECT,  // exact stochastic simulation (direct method)
+  GILLESPIE_NEXT_REACTION,  // exact stochastic simulation (Gibson-Bruck next reaction method)
+  GILLESPIE_COMPOSITION_REJECTION,  // exact stochastic simulation (composition-rejection selection)
+  TAU_LEAPING  // approximate stochastic simulation, exact steps where leaping does not pay off
+};
+
 class RunConfiguration {
  public:
   RunConfiguration(double duration, double stepInterval, std::vector<OutputField> outputFields,
@@ -18,6 +32,16 @@ class RunConfiguration {
   const std::vector<OutputField> &getOutputFields() const;
   double getAbsoluteTolerance() const;
   double getRelativeTolerance() const;
+  // per-variable tolerances (e.g. for species spanning different scales) override the defaults above
+  void setAbsoluteTolerance(const std::string &variableId, double absoluteTolerance);
+  void setRelativeTolerance(const std::string &variableId, double relativeTolerance);
+  const std::unordered_map<std::string, double> &getAbsoluteTolerances() const;
+  const std::unordered_map<std::string, double> &getRelativeTolerances() const;
+  void setIntegrator(IntegratorType integrator);
+  IntegratorType getIntegrator() const;
+  // seed of the random number generator for stochastic simulation
+  void setSeed(unsigned long seed);
+  unsigned long getSeed() const;
  private:
   const double start;
   const double duration;
@@ -25,6 +49,10 @@ class RunConfiguration {
   const std::vector<OutputField> outputFields;
   const double absoluteTolerance;
   const double relativeTolerance;
+  std::unordered_map<std::string, double> absoluteTolerances;
+  std::unordered_map<std::string, double> relativeTolerances;
+  IntegratorType integrator;
+  unsigned long seed;
 };
 
 #endif /* INCLUDE_SBMLSIM_CONFIG_RUNCONFIGURATION_H_ */
@@ -0,0 +1,257 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_BYTECODE_BATCHINTERPRETER_H_
+#define INCLUDE_SBMLSIM_INTERNAL_BYTECODE_BATCHINTERPRETER_H_
+
+#include <cmath>
+#include "sbmlsim/internal/bytecode/Bytecode.h"
+#include "sbmlsim/internal/util/MathUtil.h"
+#include "sbmlsim/internal/util/RuntimeExceptionUtil.h"
+
+class BatchInterpreter {
+ public:
+  /*
+   * BytecodeInterpreter::evaluate() for numLanes value sets at once. x, p and
+   * the stack are structure-of-arrays: value i of lane l is at
+   * [i * numLanes + l]; result[l] receives lane l. `stack` must provide
+   * bytecode.getMaxStackDepth() * numLanes slots. Each instruction is
+   * dispatched once and runs as one loop over the lanes, which the compiler
+   * can vectorize. A branch (piecewise) that all lanes take the same way is
+   * followed once; if the lanes disagree, the expression is evaluated again
+   * one lane at a time.
+   */
+  static void evaluate(const Bytecode &bytecode, unsigned int expressionId, const double *x, const double *p,
+                       double t, unsigned int numLanes, double *stack, double *result) {
+    if (!evaluateLanes(bytecode, expressionId, x, p, t, numLanes, 0, numLanes, stack, result)) {
+      for (unsigned int lane = 0; lane < numLanes; lane++) {
+        evaluateLanes(bytecode, expressionId, x, p, t, numLanes, lane, lane + 1, stack, result);
+      }
+    }
+  }
+ private:
+  BatchInterpreter() {}
+  ~BatchInterpreter() {}
+
+  template<class Function>
+  static void unary(double *a, unsigned int begin, unsigned int end, Function function) {
+    for (auto l = begin; l < end; l++) {
+      a[l] = function(a[l]);
+    }
+  }
+
+  // a = function(a, b), with a one stack row below b
+  template<class Function>
+  static void binary(double *a, const double *b, unsigned int begin, unsigned int end, Function function) {
+    for (auto l = begin; l < end; l++) {
+      a[l] = function(a[l], b[l]);
+    }
+  }
+
+  static void load(double *a, const double *values, unsigned int begin, unsigned int end) {
+    for (auto l = begin; l < end; l++) {
+      a[l] = values[l];
+    }
+  }
+
+  static void loadRatio(double *a, const double *values, const double *sizes, unsigned int begin, unsigned int end) {
+    for (auto l = begin; l < end; l++) {
+      a[l] = values[l] / sizes[l];
+    }
+  }
+
+  // lanes [begin, end); false if they disagree on a branch
+  static bool evaluateLanes(const Bytecode &bytecode, unsigned int expressionId, const double *x, const double *p,
+                            double t, unsigned int numLanes, unsigned int begin, unsigned int end, double *stack,
+                            double *result) {
+    const Instruction *pc = bytecode.getEntryPoint(expressionId);
+    double *sp = stack;  // next free row
+
+    for (;;) {
+      switch (pc->op) {
+        // operands
+        case OpCode::PUSH_CONSTANT:
+          unary(sp, begin, end, [pc](double) { return pc->value; });
+          sp += numLanes;
+          break;
+        case OpCode::LOAD_STATE:
+          load(sp, x + pc->operand * numLanes, begin, end);
+          sp += numLanes;
+          break;
+        case OpCode::LOAD_PARAMETER:
+          load(sp, p + pc->operand * numLanes, begin, end);
+          sp += numLanes;
+          break;
+        case OpCode::LOAD_CONCENTRATION_XX:
+          loadRatio(sp, x + pc->operand * numLanes, x + pc->compartment * numLanes, begin, end);
+          sp += numLanes;
+          break;
+        case OpCode::LOAD_CONCENTRATION_XP:
+          loadRatio(sp, x + pc->operand * numLanes, p + pc->compartment * numLanes, begin, end);
+          sp += numLanes;
+          break;
+        case OpCode::LOAD_CONCENTRATION_PX:
+          loadRatio(sp, p + pc->operand * numLanes, x + pc->compartment * numLanes, begin, end);
+          sp += numLanes;
+          break;
+        case OpCode::LOAD_CONCENTRATION_PP:
+          loadRatio(sp, p + pc->operand * numLanes, p + pc->compartment * numLanes, begin, end);
+          sp += numLanes;
+          break;
+        case OpCode::LOAD_TIME:
+          unary(sp, begin, end, [t](double) { return t; });
+          sp += numLanes;
+          break;
+        // arithmetic
+        case OpCode::ADD:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) { return a + b; });
+          break;
+        case OpCode::SUBTRACT:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) { return a - b; });
+          break;
+        case OpCode::MULTIPLY:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) { return a * b; });
+          break;
+        case OpCode::DIVIDE:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) { return a / b; });
+          break;
+        case OpCode::NEGATE:
+          unary(sp - numLanes, begin, end, [](double a) { return -a; });
+          break;
+        case OpCode::POWER:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) { return std::pow(a, b); });
+          break;
+        // functions
+        case OpCode::EXP:
+          unary(sp - numLanes, begin, end, [](double a) { return std::exp(a); });
+          break;
+        case OpCode::LN:
+          unary(sp - numLanes, begin, end, [](double a) { return std::log(a); });
+          break;
+        case OpCode::LOG:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) { return std::log(b) / std::log(a); });
+          break;
+        case OpCode::ABS:
+          unary(sp - numLanes, begin, end, [](double a) { return std::fabs(a); });
+          break;
+        case OpCode::CEILING:
+          unary(sp - numLanes, begin, end, [](double a) { return std::ceil(a); });
+          break;
+        case OpCode::FLOOR:
+          unary(sp - numLanes, begin, end, [](double a) { return std::floor(a); });
+          break;
+        case OpCode::FACTORIAL:
+          unary(sp - numLanes, begin, end, [](double a) {
+            return MathUtil::factorial(static_cast<unsigned long long>(a));
+          });
+          break;
+        case OpCode::SIN:
+          unary(sp - numLanes, begin, end, [](double a) { return std::sin(a); });
+          break;
+        case OpCode::COS:
+          unary(sp - numLanes, begin, end, [](double a) { return std::cos(a); });
+          break;
+        case OpCode::TAN:
+          unary(sp - numLanes, begin, end, [](double a) { return std::tan(a); });
+          break;
+        case OpCode::SINH:
+          unary(sp - numLanes, begin, end, [](double a) { return std::sinh(a); });
+          break;
+        case OpCode::COSH:
+          unary(sp - numLanes, begin, end, [](double a) { return std::cosh(a); });
+          break;
+        case OpCode::TANH:
+          unary(sp - numLanes, begin, end, [](double a) { return std::tanh(a); });
+          break;
+        case OpCode::ARCSIN:
+          unary(sp - numLanes, begin, end, [](double a) { return std::asin(a); });
+          break;
+        case OpCode::ARCCOS:
+          unary(sp - numLanes, begin, end, [](double a) { return std::acos(a); });
+          break;
+        case OpCode::ARCTAN:
+          unary(sp - numLanes, begin, end, [](double a) { return std::atan(a); });
+          break;
+        // relational
+        case OpCode::LT:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) { return a < b ? 1.0 : 0.0; });
+          break;
+        case OpCode::LEQ:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) { return a <= b ? 1.0 : 0.0; });
+          break;
+        case OpCode::GT:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) { return a > b ? 1.0 : 0.0; });
+          break;
+        case OpCode::GEQ:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) { return a >= b ? 1.0 : 0.0; });
+          break;
+        case OpCode::EQ:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) { return a == b ? 1.0 : 0.0; });
+          break;
+        case OpCode::NEQ:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) { return a != b ? 1.0 : 0.0; });
+          break;
+        // logical
+        case OpCode::AND:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) {
+            return (a != 0.0 && b != 0.0) ? 1.0 : 0.0;
+          });
+          break;
+        case OpCode::OR:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) {
+            return (a != 0.0 || b != 0.0) ? 1.0 : 0.0;
+          });
+          break;
+        case OpCode::XOR:
+          sp -= numLanes;
+          binary(sp - numLanes, sp, begin, end, [](double a, double b) {
+            return ((a != 0.0) != (b != 0.0)) ? 1.0 : 0.0;
+          });
+          break;
+        case OpCode::NOT:
+          unary(sp - numLanes, begin, end, [](double a) { return a == 0.0 ? 1.0 : 0.0; });
+          break;
+        // control flow
+        case OpCode::JUMP:
+          pc += pc->operand;
+          continue;
+        case OpCode::JUMP_IF_FALSE: {
+          sp -= numLanes;
+          unsigned int numFalse = 0;
+          for (auto l = begin; l < end; l++) {
+            numFalse += sp[l] == 0.0 ? 1 : 0;
+          }
+          if (numFalse == end - begin) {
+            pc += pc->operand;
+            continue;
+          }
+          if (numFalse > 0) {
+            return false;
+          }
+          break;
+        }
+        case OpCode::RETURN:
+          load(result, sp - numLanes, begin, end);
+          return true;
+        case OpCode::LOAD_SYMBOL:
+          // unbound symbol
+          RuntimeExceptionUtil::throwInvalidFlowException();
+          break;
+      }
+      ++pc;
+    }
+  }
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_BYTECODE_BATCHINTERPRETER_H_ */
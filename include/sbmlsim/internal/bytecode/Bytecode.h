@@ -0,0 +1,64 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_BYTECODE_BYTECODE_H_
+#define INCLUDE_SBMLSIM_INTERNAL_BYTECODE_BYTECODE_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "sbmlsim/internal/bytecode/Instruction.h"
+
+/*
+ * Where the value of a symbol lives: the integrated state x, or the parameter
+ * block p when `parameter` is set. Species whose value is a concentration are
+ * loaded as (x or p)[index] / (x or p)[compartmentIndex].
+ */
+struct SymbolBinding {
+  bool parameter;
+  unsigned int index;
+  bool concentration;
+  bool compartmentParameter;
+  unsigned int compartmentIndex;
+};
+
+// the value of an expression, stored to a symbol (assignment rules, initial assignments)
+struct SymbolAssignment {
+  unsigned int expressionId;
+  SymbolBinding target;
+};
+
+/*
+ * Flat storage of compiled expressions. Every expression is a postfix program
+ * terminated by RETURN; programs are appended to a single instruction array and
+ * addressed by the expression id returned from addExpression().
+ */
+class Bytecode {
+ public:
+  Bytecode();
+  Bytecode(const Bytecode &bytecode);
+  ~Bytecode();
+  // construction (used by BytecodeCompiler)
+  unsigned int getSize() const;
+  void emit(OpCode op, unsigned int operand = 0, double value = 0.0);
+  void patchOperand(unsigned int position, unsigned int operand);
+  unsigned int addSymbol(const std::string &name);
+  unsigned int addExpression(unsigned int entryPoint, unsigned int stackDepth);
+  // rewrites every LOAD_SYMBOL with bindings[symbolId]
+  void bindSymbols(const std::vector<SymbolBinding> &bindings);
+  // evaluation
+  const Instruction *getEntryPoint(unsigned int expressionId) const;
+  unsigned int getNumExpressions() const;
+  unsigned int getMaxStackDepth() const;
+  const std::string &getSymbol(unsigned int symbolId) const;
+  unsigned int getNumSymbols() const;
+  // state and parameter indices read by an expression (after bindSymbols)
+  void collectLoads(unsigned int expressionId, std::vector<unsigned int> &stateIndices,
+                    std::vector<unsigned int> &parameterIndices) const;
+  bool dependsOnTime(unsigned int expressionId) const;
+ private:
+  std::vector<Instruction> instructions;
+  std::vector<unsigned int> entryPoints;
+  std::vector<std::string> symbols;
+  std::unordered_map<std::string, unsigned int> symbolIndexMap;
+  unsigned int maxStackDepth;
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_BYTECODE_BYTECODE_H_ */
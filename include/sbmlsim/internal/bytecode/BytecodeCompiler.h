@@ -0,0 +1,25 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_BYTECODE_BYTECODECOMPILER_H_
+#define INCLUDE_SBMLSIM_INTERNAL_BYTECODE_BYTECODECOMPILER_H_
+
+#include <sbml/SBMLTypes.h>
+#include "sbmlsim/internal/bytecode/Bytecode.h"
+
+class BytecodeCompiler {
+ public:
+  // compiles node into bytecode and returns the id of the new expression
+  static unsigned int compile(const ASTNode *node, Bytecode &bytecode);
+ private:
+  BytecodeCompiler() {}
+  ~BytecodeCompiler() {}
+  static void compileNode(const ASTNode *node, Bytecode &bytecode, unsigned int &depth, unsigned int &maxDepth);
+  static void compileFoldedNode(const ASTNode *node, OpCode op, double identity, Bytecode &bytecode,
+                                unsigned int &depth, unsigned int &maxDepth);
+  static void compileRelationalNode(const ASTNode *node, OpCode op, Bytecode &bytecode,
+                                    unsigned int &depth, unsigned int &maxDepth);
+  static void compilePiecewiseNode(const ASTNode *node, Bytecode &bytecode, unsigned int &depth,
+                                   unsigned int &maxDepth);
+  static void emit(Bytecode &bytecode, OpCode op, int stackEffect, unsigned int &depth, unsigned int &maxDepth,
+                   unsigned int operand = 0, double value = 0.0);
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_BYTECODE_BYTECODECOMPILER_H_ */
@@ -0,0 +1,188 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_BYTECODE_BYTECODEINTERPRETER_H_
+#define INCLUDE_SBMLSIM_INTERNAL_BYTECODE_BYTECODEINTERPRETER_H_
+
+#include <cmath>
+#include "sbmlsim/internal/bytecode/Bytecode.h"
+#include "sbmlsim/internal/util/MathUtil.h"
+#include "sbmlsim/internal/util/RuntimeExceptionUtil.h"
+
+class BytecodeInterpreter {
+ public:
+  /*
+   * Evaluates a compiled expression against state x and parameter block p.
+   * Symbols must have been bound (Bytecode::bindSymbols) and `stack` must
+   * provide at least bytecode.getMaxStackDepth() slots.
+   */
+  static double evaluate(const Bytecode &bytecode, unsigned int expressionId, const double *x, const double *p,
+                         double t, double *stack) {
+    const Instruction *pc = bytecode.getEntryPoint(expressionId);
+    double *sp = stack;  // next free slot
+
+    for (;;) {
+      switch (pc->op) {
+        // operands
+        case OpCode::PUSH_CONSTANT:
+          *sp++ = pc->value;
+          break;
+        case OpCode::LOAD_STATE:
+          *sp++ = x[pc->operand];
+          break;
+        case OpCode::LOAD_PARAMETER:
+          *sp++ = p[pc->operand];
+          break;
+        case OpCode::LOAD_CONCENTRATION_XX:
+          *sp++ = x[pc->operand] / x[pc->compartment];
+          break;
+        case OpCode::LOAD_CONCENTRATION_XP:
+          *sp++ = x[pc->operand] / p[pc->compartment];
+          break;
+        case OpCode::LOAD_CONCENTRATION_PX:
+          *sp++ = p[pc->operand] / x[pc->compartment];
+          break;
+        case OpCode::LOAD_CONCENTRATION_PP:
+          *sp++ = p[pc->operand] / p[pc->compartment];
+          break;
+        case OpCode::LOAD_TIME:
+          *sp++ = t;
+          break;
+        // arithmetic
+        case OpCode::ADD:
+          --sp;
+          sp[-1] += sp[0];
+          break;
+        case OpCode::SUBTRACT:
+          --sp;
+          sp[-1] -= sp[0];
+          break;
+        case OpCode::MULTIPLY:
+          --sp;
+          sp[-1] *= sp[0];
+          break;
+        case OpCode::DIVIDE:
+          --sp;
+          sp[-1] /= sp[0];
+          break;
+        case OpCode::NEGATE:
+          sp[-1] = -sp[-1];
+          break;
+        case OpCode::POWER:
+          --sp;
+          sp[-1] = std::pow(sp[-1], sp[0]);
+          break;
+        // functions
+        case OpCode::EXP:
+          sp[-1] = std::exp(sp[-1]);
+          break;
+        case OpCode::LN:
+          sp[-1] = std::log(sp[-1]);
+          break;
+        case OpCode::LOG:
+          --sp;
+          sp[-1] = std::log(sp[0]) / std::log(sp[-1]);
+          break;
+        case OpCode::ABS:
+          sp[-1] = std::fabs(sp[-1]);
+          break;
+        case OpCode::CEILING:
+          sp[-1] = std::ceil(sp[-1]);
+          break;
+        case OpCode::FLOOR:
+          sp[-1] = std::floor(sp[-1]);
+          break;
+        case OpCode::FACTORIAL:
+          sp[-1] = MathUtil::factorial(static_cast<unsigned long long>(sp[-1]));
+          break;
+        case OpCode::SIN:
+          sp[-1] = std::sin(sp[-1]);
+          break;
+        case OpCode::COS:
+          sp[-1] = std::cos(sp[-1]);
+          break;
+        case OpCode::TAN:
+          sp[-1] = std::tan(sp[-1]);
+          break;
+        case OpCode::SINH:
+          sp[-1] = std::sinh(sp[-1]);
+          break;
+        case OpCode::COSH:
+          sp[-1] = std::cosh(sp[-1]);
+          break;
+        case OpCode::TANH:
+          sp[-1] = std::tanh(sp[-1]);
+          break;
+        case OpCode::ARCSIN:
+          sp[-1] = std::asin(sp[-1]);
+          break;
+        case OpCode::ARCCOS:
+          sp[-1] = std::acos(sp[-1]);
+          break;
+        case OpCode::ARCTAN:
+          sp[-1] = std::atan(sp[-1]);
+          break;
+        // relational
+        case OpCode::LT:
+          --sp;
+          sp[-1] = sp[-1] < sp[0] ? 1.0 : 0.0;
+          break;
+        case OpCode::LEQ:
+          --sp;
+          sp[-1] = sp[-1] <= sp[0] ? 1.0 : 0.0;
+          break;
+        case OpCode::GT:
+          --sp;
+          sp[-1] = sp[-1] > sp[0] ? 1.0 : 0.0;
+          break;
+        case OpCode::GEQ:
+          --sp;
+          sp[-1] = sp[-1] >= sp[0] ? 1.0 : 0.0;
+          break;
+        case OpCode::EQ:
+          --sp;
+          sp[-1] = sp[-1] == sp[0] ? 1.0 : 0.0;
+          break;
+        case OpCode::NEQ:
+          --sp;
+          sp[-1] = sp[-1] != sp[0] ? 1.0 : 0.0;
+          break;
+        // logical
+        case OpCode::AND:
+          --sp;
+          sp[-1] = (sp[-1] != 0.0 && sp[0] != 0.0) ? 1.0 : 0.0;
+          break;
+        case OpCode::OR:
+          --sp;
+          sp[-1] = (sp[-1] != 0.0 || sp[0] != 0.0) ? 1.0 : 0.0;
+          break;
+        case OpCode::XOR:
+          --sp;
+          sp[-1] = ((sp[-1] != 0.0) != (sp[0] != 0.0)) ? 1.0 : 0.0;
+          break;
+        case OpCode::NOT:
+          sp[-1] = sp[-1] == 0.0 ? 1.0 : 0.0;
+          break;
+        // control flow
+        case OpCode::JUMP:
+          pc += pc->operand;
+          continue;
+        case OpCode::JUMP_IF_FALSE:
+          if (*--sp == 0.0) {
+            pc += pc->operand;
+            continue;
+          }
+          break;
+        case OpCode::RETURN:
+          return sp[-1];
+        case OpCode::LOAD_SYMBOL:
+          // unbound symbol
+          RuntimeExceptionUtil::throwInvalidFlowException();
+          break;
+      }
+      ++pc;
+    }
+  }
+ private:
+  BytecodeInterpreter() {}
+  ~BytecodeInterpreter() {}
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_BYTECODE_BYTECODEINTERPRETER_H_ */
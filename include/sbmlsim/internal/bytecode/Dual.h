@@ -0,0 +1,14 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_BYTECODE_DUAL_H_
+#define INCLUDE_SBMLSIM_INTERNAL_BYTECODE_DUAL_H_
+
+/*
+ * Dual number value + derivative * eps (eps^2 = 0) for forward-mode automatic
+ * differentiation: derivative carries the directional derivative of value
+ * along the seeded direction.
+ */
+struct Dual {
+  double value;
+  double derivative;
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_BYTECODE_DUAL_H_ */
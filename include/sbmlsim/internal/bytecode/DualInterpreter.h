@@ -0,0 +1,247 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_BYTECODE_DUALINTERPRETER_H_
+#define INCLUDE_SBMLSIM_INTERNAL_BYTECODE_DUALINTERPRETER_H_
+
+#include <cmath>
+#include "sbmlsim/internal/bytecode/Bytecode.h"
+#include "sbmlsim/internal/bytecode/Dual.h"
+#include "sbmlsim/internal/util/MathUtil.h"
+#include "sbmlsim/internal/util/RuntimeExceptionUtil.h"
+
+class DualInterpreter {
+ public:
+  /*
+   * Forward-mode counterpart of BytecodeInterpreter::evaluate(): evaluates a
+   * compiled expression on dual numbers, where dx, dp and dt are the tangents
+   * (seed direction) of x, p and t. Returns the value together with its
+   * directional derivative. `stack` must provide at least
+   * bytecode.getMaxStackDepth() slots.
+   *
+   * Piecewise-constant operations (relational, logical, floor, ceiling,
+   * factorial) have a zero derivative; branches are taken on the value.
+   */
+  static Dual evaluate(const Bytecode &bytecode, unsigned int expressionId, const double *x, const double *dx,
+                       const double *p, const double *dp, double t, double dt, Dual *stack) {
+    const Instruction *pc = bytecode.getEntryPoint(expressionId);
+    Dual *sp = stack;  // next free slot
+
+    for (;;) {
+      switch (pc->op) {
+        // operands
+        case OpCode::PUSH_CONSTANT:
+          sp->value = pc->value;
+          sp->derivative = 0.0;
+          sp++;
+          break;
+        case OpCode::LOAD_STATE:
+          sp->value = x[pc->operand];
+          sp->derivative = dx[pc->operand];
+          sp++;
+          break;
+        case OpCode::LOAD_PARAMETER:
+          sp->value = p[pc->operand];
+          sp->derivative = dp[pc->operand];
+          sp++;
+          break;
+        case OpCode::LOAD_CONCENTRATION_XX:
+          pushQuotient(sp++, x[pc->operand], dx[pc->operand], x[pc->compartment], dx[pc->compartment]);
+          break;
+        case OpCode::LOAD_CONCENTRATION_XP:
+          pushQuotient(sp++, x[pc->operand], dx[pc->operand], p[pc->compartment], dp[pc->compartment]);
+          break;
+        case OpCode::LOAD_CONCENTRATION_PX:
+          pushQuotient(sp++, p[pc->operand], dp[pc->operand], x[pc->compartment], dx[pc->compartment]);
+          break;
+        case OpCode::LOAD_CONCENTRATION_PP:
+          pushQuotient(sp++, p[pc->operand], dp[pc->operand], p[pc->compartment], dp[pc->compartment]);
+          break;
+        case OpCode::LOAD_TIME:
+          sp->value = t;
+          sp->derivative = dt;
+          sp++;
+          break;
+        // arithmetic
+        case OpCode::ADD:
+          --sp;
+          sp[-1].value += sp[0].value;
+          sp[-1].derivative += sp[0].derivative;
+          break;
+        case OpCode::SUBTRACT:
+          --sp;
+          sp[-1].value -= sp[0].value;
+          sp[-1].derivative -= sp[0].derivative;
+          break;
+        case OpCode::MULTIPLY:
+          --sp;
+          sp[-1].derivative = sp[-1].derivative * sp[0].value + sp[-1].value * sp[0].derivative;
+          sp[-1].value *= sp[0].value;
+          break;
+        case OpCode::DIVIDE:
+          --sp;
+          pushQuotient(sp - 1, sp[-1].value, sp[-1].derivative, sp[0].value, sp[0].derivative);
+          break;
+        case OpCode::NEGATE:
+          sp[-1].value = -sp[-1].value;
+          sp[-1].derivative = -sp[-1].derivative;
+          break;
+        case OpCode::POWER: {
+          --sp;
+          // d(u^v) = v * u^(v-1) * du + u^v * ln(u) * dv
+          double u = sp[-1].value;
+          double v = sp[0].value;
+          double value = std::pow(u, v);
+          double derivative = sp[-1].derivative == 0.0 ? 0.0 : v * std::pow(u, v - 1.0) * sp[-1].derivative;
+          if (sp[0].derivative != 0.0) {
+            derivative += value * std::log(u) * sp[0].derivative;
+          }
+          sp[-1].value = value;
+          sp[-1].derivative = derivative;
+          break;
+        }
+        // functions
+        case OpCode::EXP:
+          sp[-1].value = std::exp(sp[-1].value);
+          sp[-1].derivative *= sp[-1].value;
+          break;
+        case OpCode::LN:
+          sp[-1].derivative /= sp[-1].value;
+          sp[-1].value = std::log(sp[-1].value);
+          break;
+        case OpCode::LOG: {
+          --sp;
+          // log_b(a) = ln(a) / ln(b), with b = sp[-1] and a = sp[0]
+          double lnBase = std::log(sp[-1].value);
+          double lnArgument = std::log(sp[0].value);
+          sp[-1].derivative = (sp[0].derivative / sp[0].value * lnBase - lnArgument * sp[-1].derivative / sp[-1].value)
+              / (lnBase * lnBase);
+          sp[-1].value = lnArgument / lnBase;
+          break;
+        }
+        case OpCode::ABS:
+          if (sp[-1].value < 0.0) {
+            sp[-1].value = -sp[-1].value;
+            sp[-1].derivative = -sp[-1].derivative;
+          }
+          break;
+        case OpCode::CEILING:
+          setConstant(sp - 1, std::ceil(sp[-1].value));
+          break;
+        case OpCode::FLOOR:
+          setConstant(sp - 1, std::floor(sp[-1].value));
+          break;
+        case OpCode::FACTORIAL:
+          setConstant(sp - 1, MathUtil::factorial(static_cast<unsigned long long>(sp[-1].value)));
+          break;
+        case OpCode::SIN:
+          sp[-1].derivative *= std::cos(sp[-1].value);
+          sp[-1].value = std::sin(sp[-1].value);
+          break;
+        case OpCode::COS:
+          sp[-1].derivative *= -std::sin(sp[-1].value);
+          sp[-1].value = std::cos(sp[-1].value);
+          break;
+        case OpCode::TAN: {
+          double cosine = std::cos(sp[-1].value);
+          sp[-1].derivative /= cosine * cosine;
+          sp[-1].value = std::tan(sp[-1].value);
+          break;
+        }
+        case OpCode::SINH:
+          sp[-1].derivative *= std::cosh(sp[-1].value);
+          sp[-1].value = std::sinh(sp[-1].value);
+          break;
+        case OpCode::COSH:
+          sp[-1].derivative *= std::sinh(sp[-1].value);
+          sp[-1].value = std::cosh(sp[-1].value);
+          break;
+        case OpCode::TANH:
+          sp[-1].value = std::tanh(sp[-1].value);
+          sp[-1].derivative *= 1.0 - sp[-1].value * sp[-1].value;
+          break;
+        case OpCode::ARCSIN:
+          sp[-1].derivative /= std::sqrt(1.0 - sp[-1].value * sp[-1].value);
+          sp[-1].value = std::asin(sp[-1].value);
+          break;
+        case OpCode::ARCCOS:
+          sp[-1].derivative /= -std::sqrt(1.0 - sp[-1].value * sp[-1].value);
+          sp[-1].value = std::acos(sp[-1].value);
+          break;
+        case OpCode::ARCTAN:
+          sp[-1].derivative /= 1.0 + sp[-1].value * sp[-1].value;
+          sp[-1].value = std::atan(sp[-1].value);
+          break;
+        // relational
+        case OpCode::LT:
+          --sp;
+          setConstant(sp - 1, sp[-1].value < sp[0].value ? 1.0 : 0.0);
+          break;
+        case OpCode::LEQ:
+          --sp;
+          setConstant(sp - 1, sp[-1].value <= sp[0].value ? 1.0 : 0.0);
+          break;
+        case OpCode::GT:
+          --sp;
+          setConstant(sp - 1, sp[-1].value > sp[0].value ? 1.0 : 0.0);
+          break;
+        case OpCode::GEQ:
+          --sp;
+          setConstant(sp - 1, sp[-1].value >= sp[0].value ? 1.0 : 0.0);
+          break;
+        case OpCode::EQ:
+          --sp;
+          setConstant(sp - 1, sp[-1].value == sp[0].value ? 1.0 : 0.0);
+          break;
+        case OpCode::NEQ:
+          --sp;
+          setConstant(sp - 1, sp[-1].value != sp[0].value ? 1.0 : 0.0);
+          break;
+        // logical
+        case OpCode::AND:
+          --sp;
+          setConstant(sp - 1, (sp[-1].value != 0.0 && sp[0].value != 0.0) ? 1.0 : 0.0);
+          break;
+        case OpCode::OR:
+          --sp;
+          setConstant(sp - 1, (sp[-1].value != 0.0 || sp[0].value != 0.0) ? 1.0 : 0.0);
+          break;
+        case OpCode::XOR:
+          --sp;
+          setConstant(sp - 1, ((sp[-1].value != 0.0) != (sp[0].value != 0.0)) ? 1.0 : 0.0);
+          break;
+        case OpCode::NOT:
+          setConstant(sp - 1, sp[-1].value == 0.0 ? 1.0 : 0.0);
+          break;
+        // control flow
+        case OpCode::JUMP:
+          pc += pc->operand;
+          continue;
+        case OpCode::JUMP_IF_FALSE:
+          if ((--sp)->value == 0.0) {
+            pc += pc->operand;
+            continue;
+          }
+          break;
+        case OpCode::RETURN:
+          return sp[-1];
+        case OpCode::LOAD_SYMBOL:
+          // unbound symbol
+          RuntimeExceptionUtil::throwInvalidFlowException();
+          break;
+      }
+      ++pc;
+    }
+  }
+ private:
+  DualInterpreter() {}
+  ~DualInterpreter() {}
+  // slot = a / b
+  static void pushQuotient(Dual *slot, double a, double da, double b, double db) {
+    slot->value = a / b;
+    slot->derivative = (da - slot->value * db) / b;
+  }
+  static void setConstant(Dual *slot, double value) {
+    slot->value = value;
+    slot->derivative = 0.0;
+  }
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_BYTECODE_DUALINTERPRETER_H_ */
@@ -0,0 +1,72 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_BYTECODE_INSTRUCTION_H_
+#define INCLUDE_SBMLSIM_INTERNAL_BYTECODE_INSTRUCTION_H_
+
+enum class OpCode : unsigned char {
+  // operands
+  PUSH_CONSTANT,       // push value
+  LOAD_SYMBOL,         // unresolved name (symbol[operand]); rewritten by Bytecode::bindSymbols()
+  LOAD_STATE,          // push x[operand]
+  LOAD_PARAMETER,      // push p[operand]
+  // species concentration: amount / compartment size, each from x or p
+  LOAD_CONCENTRATION_XX,  // push x[operand] / x[compartment]
+  LOAD_CONCENTRATION_XP,  // push x[operand] / p[compartment]
+  LOAD_CONCENTRATION_PX,  // push p[operand] / x[compartment]
+  LOAD_CONCENTRATION_PP,  // push p[operand] / p[compartment]
+  LOAD_TIME,           // push t
+  // arithmetic
+  ADD,
+  SUBTRACT,
+  MULTIPLY,
+  DIVIDE,
+  NEGATE,
+  POWER,
+  // functions
+  EXP,
+  LN,
+  LOG,            // log(base, x)
+  ABS,
+  CEILING,
+  FLOOR,
+  FACTORIAL,
+  SIN,
+  COS,
+  TAN,
+  SINH,
+  COSH,
+  TANH,
+  ARCSIN,
+  ARCCOS,
+  ARCTAN,
+  // relational (push 1.0 or 0.0)
+  LT,
+  LEQ,
+  GT,
+  GEQ,
+  EQ,
+  NEQ,
+  // logical (push 1.0 or 0.0)
+  AND,
+  OR,
+  XOR,
+  NOT,
+  // control flow (operand is a relative forward offset)
+  JUMP,
+  JUMP_IF_FALSE,  // pop a condition and jump if it is 0.0
+  RETURN
+};
+
+/*
+ * A single postfix instruction. Instructions of every compiled expression are
+ * stored back to back in one contiguous array (see Bytecode), so this struct
+ * is kept small and trivially copyable.
+ */
+struct Instruction {
+  OpCode op;
+  unsigned int operand;
+  union {
+    double value;               // PUSH_CONSTANT
+    unsigned int compartment;   // LOAD_CONCENTRATION
+  };
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_BYTECODE_INSTRUCTION_H_ */
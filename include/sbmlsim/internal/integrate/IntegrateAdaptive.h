@@ -1,6 +1,7 @@
 #ifndef INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEADAPTIVE_H_
 #define INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEADAPTIVE_H_
 
+#include <functional>
 #include <stdexcept>
 #include <boost/numeric/odeint.hpp>
 #include "sbmlsim/internal/system/SBMLSystem.h"
@@ -11,7 +12,7 @@ namespace sbmlsim {
 
 template<class Stepper, class Observer>
 size_t integrate_adaptive_detail(
-    Stepper stepper, SBMLSystem system, SBMLSystem::state &start_state,
+    Stepper stepper, SBMLSystem &system, SBMLSystem::state &start_state,
     double &start_time, double end_time, double &dt,
     Observer observer, odeint::controlled_stepper_tag) {
   typename odeint::unwrap_reference<Observer>::type &obs = observer;
@@ -28,7 +29,7 @@ size_t integrate_adaptive_detail(
     int steps = 0;
     odeint::controlled_step_result res;
     do {
-      res = st.try_step(system, start_state, start_time, dt);
+      res = st.try_step(std::ref(system), start_state, start_time, dt);
 
       // DO NOT USE failed_step_checker to make it to compatible with boost-1.54.0.
       steps++;
@@ -0,0 +1,183 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEAUTO_H_
+#define INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEAUTO_H_
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <boost/numeric/odeint.hpp>
+#include "sbmlsim/internal/system/SBMLSystem.h"
+#include "sbmlsim/internal/system/SBMLSystemDualJacobi.h"
+#include "sbmlsim/internal/system/SBMLSystemJacobi.h"
+
+using namespace boost::numeric;
+
+// attempted steps between two stiffness checks
+#define STIFFNESS_CHECK_INTERVAL 20
+// consecutive positive checks before switching to the implicit method
+#define STIFFNESS_CHECKS_TO_SWITCH 2
+// h * |lambda| beyond which dopri5 is unstable (real axis)
+#define DOPRI5_STABILITY_BOUNDARY 3.3
+// power iterations for the dominant eigenvalue estimate
+#define SPECTRAL_RADIUS_ITERATIONS 6
+
+namespace sbmlsim {
+
+struct AutoStatistics {
+  unsigned long numAcceptedSteps;
+  unsigned long numRejectedSteps;
+  unsigned long numStiffnessChecks;
+  bool stiff;         // the run ended on the implicit method
+  double switchTime;  // when it switched (start time if it started implicit)
+};
+
+namespace detail {
+
+// estimate of the dominant |eigenvalue| of df/dx by power iteration on Jacobian-vector products
+inline double estimate_spectral_radius(SBMLSystem &system, const SBMLSystem::state &x, double t,
+                                       SBMLSystem::state &v, SBMLSystem::state &w) {
+  if (x.size() == 0) {
+    return 0.0;
+  }
+  std::fill(v.begin(), v.end(), 1.0 / std::sqrt(static_cast<double>(x.size())));
+  double radius = 0.0;
+  for (auto i = 0; i < SPECTRAL_RADIUS_ITERATIONS; i++) {
+    system.directionalDerivative(x, v, NULL, t, 0.0, w);
+    radius = ublas::norm_2(w);
+    if (radius == 0.0) {
+      break;
+    }
+    ublas::noalias(v) = w / radius;
+  }
+  return radius;
+}
+
+} /* namespace detail */
+
+/*
+ * Same output loop as integrate_const(), stepping adaptively with dopri5 and
+ * switching for the rest of the run to rosenbrock4 (with the forward-mode AD
+ * Jacobian, which needs no symbolic differentiation at switch time) once the
+ * problem turns stiff. Every STIFFNESS_CHECK_INTERVAL attempted steps the
+ * explicit phase compares h * |lambda_max| with the stability boundary of
+ * dopri5, together with the rejection ratio and the shrinkage of h over the
+ * window; a step size held at the stability boundary means accuracy is no
+ * longer what limits it. With `stiff` set the run is implicit from the start
+ * and uses the analytic Jacobian (SBMLSystem::createJacobi()). After an event
+ * dopri5 restarts (its first stage is not reused) and so does the window.
+ */
+template<class Observer>
+AutoStatistics integrate_auto(
+    SBMLSystem &system, SBMLSystem::state &start_state, double start_time, double end_time, double dt,
+    double abs_err, double rel_err, bool stiff, Observer observer) {
+  typename odeint::unwrap_reference<Observer>::type &obs = observer;
+
+  AutoStatistics statistics = {};
+  statistics.stiff = stiff;
+  statistics.switchTime = start_time;
+
+  auto explicitStepper = odeint::make_controlled<odeint::runge_kutta_dopri5<SBMLSystem::state> >(abs_err, rel_err);
+  auto implicitStepper = odeint::make_controlled(abs_err, rel_err, odeint::rosenbrock4<double>());
+  std::shared_ptr<SBMLSystemJacobi> analyticJacobi;
+  std::shared_ptr<SBMLSystemDualJacobi> jacobi;
+  if (stiff) {
+    analyticJacobi = std::make_shared<SBMLSystemJacobi>(system.createJacobi());
+  }
+
+  SBMLSystem::state v(start_state.size());
+  SBMLSystem::state w(start_state.size());
+  double time = start_time;
+  double h = dt;
+  int step = 0;
+  unsigned int windowAttempts = 0;
+  unsigned int windowRejections = 0;
+  unsigned int stiffChecks = 0;
+  double windowStartStep = h;
+
+  // initial assignments and assignment rules, then triggers that already hold
+  system.handleInitialAssignment(start_state, time);
+  if (system.handleEvent(start_state, time)) {
+    system.handleAssignmentRule(start_state, time);
+  }
+
+  while (odeint::detail::less_eq_with_sign(time + dt, end_time, dt)) {
+    // observer
+    obs(start_state, time);
+
+    step++;
+    double tout = start_time + static_cast<double>(step) * dt;
+    while (odeint::detail::less_with_sign(time, tout, dt)) {
+      double stepSize = std::min(h, tout - time);
+      bool clipped = stepSize < h;
+      odeint::controlled_step_result result;
+      if (analyticJacobi) {
+        result = implicitStepper.try_step(std::make_pair(std::ref(system), std::ref(*analyticJacobi)), start_state,
+                                          time, stepSize);
+      } else if (statistics.stiff) {
+        result = implicitStepper.try_step(std::make_pair(std::ref(system), std::ref(*jacobi)), start_state, time,
+                                          stepSize);
+      } else {
+        result = explicitStepper.try_step(std::ref(system), start_state, time, stepSize);
+      }
+
+      windowAttempts++;
+      if (result == odeint::success) {
+        statistics.numAcceptedSteps++;
+        // a step shortened to hit the output point says nothing about the step size
+        h = clipped ? std::max(h, stepSize) : stepSize;
+      } else {
+        statistics.numRejectedSteps++;
+        windowRejections++;
+        h = stepSize;
+      }
+
+      if (statistics.stiff || windowAttempts < STIFFNESS_CHECK_INTERVAL) {
+        continue;
+      }
+
+      // stiffness check
+      statistics.numStiffnessChecks++;
+      double hRadius = h * detail::estimate_spectral_radius(system, start_state, time, v, w);
+      double rejectionRatio = static_cast<double>(windowRejections) / windowAttempts;
+      bool collapsed = h < 0.1 * windowStartStep;
+      if (hRadius > 0.9 * DOPRI5_STABILITY_BOUNDARY || ((rejectionRatio > 0.3 || collapsed) && hRadius > 1.0)) {
+        stiffChecks++;
+      } else {
+        stiffChecks = 0;
+      }
+      if (stiffChecks >= STIFFNESS_CHECKS_TO_SWITCH) {
+        jacobi = std::make_shared<SBMLSystemDualJacobi>(system.createDualJacobi());
+        statistics.stiff = true;
+        statistics.switchTime = time;
+      }
+      windowAttempts = 0;
+      windowRejections = 0;
+      windowStartStep = h;
+    }
+
+    // land exactly on the output point
+    time = tout;
+
+    // event; the cached derivative and the stiffness window are stale after it
+    if (system.handleEvent(start_state, time)) {
+      explicitStepper.reset();
+      windowAttempts = 0;
+      windowRejections = 0;
+      stiffChecks = 0;
+      windowStartStep = h;
+    }
+
+    // assignment rules
+    system.handleAssignmentRule(start_state, time);
+  }
+
+  // observer
+  obs(start_state, time);
+
+  return statistics;
+}
+
+} /* namespace sbmlsim */
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEAUTO_H_ */
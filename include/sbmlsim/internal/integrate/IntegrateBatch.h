@@ -0,0 +1,50 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEBATCH_H_
+#define INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEBATCH_H_
+
+#include <functional>
+#include <boost/numeric/odeint.hpp>
+#include "sbmlsim/internal/system/SBMLSystemBatch.h"
+
+using namespace boost::numeric;
+
+// lanes of a batch: enough to amortize the interpreter's dispatch, and a multiple of any vector width
+#define BATCH_NUM_LANES 16
+
+namespace sbmlsim {
+
+/*
+ * Classic fourth-order Runge-Kutta with step dt for all lanes of a batch in
+ * lockstep, observing at every step like integrate_const() does for
+ * IntegratorType::RUNGE_KUTTA_4, so each lane follows the same arithmetic as
+ * a run of its own. start_state must already hold every lane after its
+ * initial assignments (SBMLSystemBatch::setLane()). The observer is called
+ * as observer(x, t) with the whole batch state.
+ */
+template<class Observer>
+size_t integrate_batch(SBMLSystemBatch &batch, SBMLSystemBatch::state &start_state, double start_time,
+                       double end_time, double dt, Observer observer) {
+  typename odeint::unwrap_reference<Observer>::type &obs = observer;
+  odeint::runge_kutta4<SBMLSystemBatch::state> stepper;
+
+  double time = start_time;
+  size_t step = 0;
+  while (odeint::detail::less_eq_with_sign(time + dt, end_time, dt)) {
+    obs(start_state, time);
+
+    stepper.do_step(std::ref(batch), start_state, time, dt);
+
+    // direct computation of the time avoids error propagation happening when using time += dt
+    ++step;
+    time = start_time + static_cast<double>(step) * dt;
+
+    // assignment rules
+    batch.handleAssignmentRule(start_state, time);
+  }
+  obs(start_state, time);
+
+  return step;
+}
+
+} /* namespace sbmlsim */
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEBATCH_H_ */
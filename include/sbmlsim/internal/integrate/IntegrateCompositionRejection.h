@@ -0,0 +1,107 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATECOMPOSITIONREJECTION_H_
+#define INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATECOMPOSITIONREJECTION_H_
+
+#include <algorithm>
+#include <vector>
+#include <boost/numeric/odeint.hpp>
+#include "sbmlsim/internal/integrate/IntegrateDirect.h"
+#include "sbmlsim/internal/system/DependencyGraph.h"
+#include "sbmlsim/internal/system/PropensityGroups.h"
+#include "sbmlsim/internal/system/SBMLSystem.h"
+
+using namespace boost::numeric;
+
+namespace sbmlsim {
+
+namespace detail {
+
+// all propensities, regrouped
+inline void group_propensities(SBMLSystem &system, const SBMLSystem::state &x, double t,
+                               std::vector<double> &propensities, PropensityGroups &groups) {
+  system.evaluatePropensities(x, t, propensities);
+  for (unsigned int i = 0; i < propensities.size(); i++) {
+    check_propensity(propensities[i]);
+    groups.update(i, propensities[i]);
+  }
+}
+
+} /* namespace detail */
+
+/*
+ * Direct method with composition-rejection selection (Slepoy, Thompson and
+ * Plimpton): same results and output as integrate_direct(), but reactions
+ * are kept in power-of-two propensity groups (PropensityGroups) and only the
+ * propensities that read what the last reaction changed are re-evaluated
+ * (SBMLSystem::getReactionDependencyGraph()). The cost of a firing depends
+ * on the spread of the propensities, not on the number of reactions.
+ */
+template<class Random, class Observer>
+SSAStatistics integrate_composition_rejection(
+    SBMLSystem &system, SBMLSystem::state &start_state, double start_time, double end_time, double dt,
+    Random &random, Observer observer) {
+  typename odeint::unwrap_reference<Observer>::type &obs = observer;
+
+  SSAStatistics statistics = {};
+  auto numReactions = system.getNumReactions();
+  auto &dependencies = system.getReactionDependencyGraph();
+  std::vector<double> propensities(numReactions);
+  PropensityGroups groups(numReactions);
+  auto uniform = [&random]() { return detail::random_uniform(random); };
+  bool hasEvents = system.getNumEvents() > 0;
+  SBMLSystem::state previousState(start_state.size());
+  std::vector<double> previousParameters;
+  double time = start_time;
+  unsigned long step = 0;
+
+  // initial assignments and assignment rules
+  system.handleInitialAssignment(start_state, time);
+  if (hasEvents) {
+    system.handleEvent(start_state, time);
+  }
+  detail::group_propensities(system, start_state, time, propensities, groups);
+
+  while (odeint::detail::less_eq_with_sign(start_time + static_cast<double>(step) * dt, end_time, dt)) {
+    double next_time = time + detail::random_waiting_time(random, groups.getTotal());
+
+    // observer, and events at the output points
+    if (detail::observe_until(system, start_state, start_time, end_time, dt, next_time, step, obs,
+                              statistics.numOutputPoints, hasEvents, time)) {
+      detail::group_propensities(system, start_state, time, propensities, groups);
+      continue;
+    }
+    if (!odeint::detail::less_eq_with_sign(next_time, end_time, dt)) {
+      break;
+    }
+
+    auto j = groups.select(uniform);
+    time = next_time;
+    system.fireReaction(j, start_state, time);
+    statistics.numFirings++;
+
+    // event
+    if (hasEvents) {
+      previousState = start_state;
+      previousParameters = system.getParameterValues();
+      system.handleEvent(start_state, time);
+      if (!std::equal(start_state.begin(), start_state.end(), previousState.begin())
+          || system.getParameterValues() != previousParameters) {
+        detail::group_propensities(system, start_state, time, propensities, groups);
+        continue;
+      }
+    }
+
+    // propensities that read what j changed
+    auto &affected = dependencies.getSuccessors(j);
+    system.evaluatePropensities(start_state, time, affected, propensities);
+    for (auto i : affected) {
+      detail::check_propensity(propensities[i]);
+      groups.update(i, propensities[i]);
+    }
+  }
+
+  return statistics;
+}
+
+} /* namespace sbmlsim */
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATECOMPOSITIONREJECTION_H_ */
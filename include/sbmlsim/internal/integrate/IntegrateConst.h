@@ -1,6 +1,10 @@
 #ifndef INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATECONST_H_
 #define INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATECONST_H_
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
 #include <boost/numeric/odeint.hpp>
 #include "sbmlsim/internal/system/SBMLSystem.h"
 #include "sbmlsim/internal/integrate/IntegrateAdaptive.h"
@@ -21,21 +25,17 @@ size_t integrate_const_detail(
   const double time_step = dt;
   int step = 0;
 
-  while (odeint::detail::less_eq_with_sign(time + time_step, end_time, dt)) {
-    // TODO create dependency graph for assignmentRules and initialAssignments
-    // assignment rules
-    system.handleAssignmentRule(start_state, time);
-
-    // initial assignments
-    system.handleInitialAssignment(start_state, time);
-
-    // assignment rules
+  // initial assignments and assignment rules, then triggers that already hold
+  system.handleInitialAssignment(start_state, time);
+  if (system.handleEvent(start_state, time)) {
     system.handleAssignmentRule(start_state, time);
+  }
 
+  while (odeint::detail::less_eq_with_sign(time + time_step, end_time, dt)) {
     // observer
     obs(start_state, time);
 
-    st.do_step(system, start_state, time, dt);
+    st.do_step(std::ref(system), start_state, time, dt);
 
     // direct computation of the time avoids error propagation happening when using time += dt
     // we need clumsy type analysis to get boost units working here
@@ -44,10 +44,10 @@ size_t integrate_const_detail(
 
     // event
     system.handleEvent(start_state, time);
-  }
 
-  // assignment rules
-  system.handleAssignmentRule(start_state, time);
+    // assignment rules
+    system.handleAssignmentRule(start_state, time);
+  }
 
   // observer
   obs(start_state, time);
@@ -67,22 +67,18 @@ size_t integrate_const_detail(
   int real_steps = 0;
   int step = 0;
 
-  while (odeint::detail::less_eq_with_sign(time + time_step, end_time, dt)) {
-    // TODO create dependency graph for assignmentRules and initialAssignments
-    // assignment rules
-    system.handleAssignmentRule(start_state, time);
-
-    // initial assignments
-    system.handleInitialAssignment(start_state, time);
-
-    // assignment rules
+  // initial assignments and assignment rules, then triggers that already hold
+  system.handleInitialAssignment(start_state, time);
+  if (system.handleEvent(start_state, time)) {
     system.handleAssignmentRule(start_state, time);
+  }
 
+  while (odeint::detail::less_eq_with_sign(time + time_step, end_time, dt)) {
     // observer
     obs(start_state, time);
 
     // integrate_adaptive_checked uses the given checker to throw if an overflow occurs
-    real_steps += odeint::detail::integrate_adaptive(stepper, system, start_state, time,
+    real_steps += odeint::detail::integrate_adaptive(std::ref(stepper), std::ref(system), start_state, time,
                                                      time + time_step, dt,
                                                      odeint::null_observer(), odeint::controlled_stepper_tag());
 
@@ -93,14 +89,166 @@ size_t integrate_const_detail(
 
     // event
     system.handleEvent(start_state, time);
+
+    // assignment rules
+    system.handleAssignmentRule(start_state, time);
+  }
+
+  // observer
+  obs(start_state, time);
+
+  return real_steps;
+}
+
+// relative accuracy of located event times
+#define EVENT_TIME_TOLERANCE 1e-12
+
+namespace detail {
+
+inline double event_time_tolerance(double t) {
+  return EVENT_TIME_TOLERANCE * std::max(1.0, std::fabs(t));
+}
+
+/*
+ * Earliest time in (t0, t1] where the root function of event `index` becomes
+ * positive, given root(t0) <= 0 < root(t1). Illinois iteration on the dense
+ * output of the last step; the returned time is always on the positive side.
+ */
+template<class Stepper>
+double locate_event(Stepper &stepper, SBMLSystem &system, unsigned int index, double t0, double root0, double t1,
+                    double root1, SBMLSystem::state &x, std::vector<double> &roots) {
+  const int MAX_ITERATIONS = 100;
+  double a = t0, fa = root0;
+  double b = t1, fb = root1;
+  int side = 0;
+  for (auto i = 0; i < MAX_ITERATIONS && b - a > event_time_tolerance(b); i++) {
+    double c = (a * fb - b * fa) / (fb - fa);
+    if (!(c > a && c < b)) {
+      c = 0.5 * (a + b);
+    }
+    stepper.calc_state(c, x);
+    system.evaluateEventRoots(x, c, roots);
+    double fc = roots[index];
+    if (fc > 0.0) {
+      b = c;
+      fb = fc;
+      if (side == -1) {
+        fa *= 0.5;
+      }
+      side = -1;
+    } else {
+      a = c;
+      fa = fc;
+      if (side == 1) {
+        fb *= 0.5;
+      }
+      side = 1;
+    }
   }
+  return b;
+}
+
+} /* namespace detail */
+
+/*
+ * Dense output: the stepper keeps its own adaptive step sequence (and dopri5
+ * its FSAL stage) across output points, which are interpolated.
+ *
+ * Events are located on the step sequence rather than the output grid: after
+ * every step the event root functions are compared with their values at the
+ * start of the step, and the earliest trigger that became true is found on
+ * the interpolant (detail::locate_event). Outputs up to that time are
+ * emitted, the triggered events are executed (with any events their
+ * assignments trigger, see SBMLSystem::handleEvent()), and the stepper
+ * restarts from there.
+ */
+template<class Stepper, class Observer>
+size_t integrate_const_detail(
+    Stepper &stepper, SBMLSystem &system, SBMLSystem::state &start_state,
+    double start_time, double end_time, double dt,
+    Observer observer, odeint::dense_output_stepper_tag) {
+  typename odeint::unwrap_reference<Observer>::type &obs = observer;
+  typename odeint::unwrap_reference<Stepper>::type &st = stepper;
+
+  const double time_step = dt;
+  int real_steps = 0;
+  int step = 0;
+  double time = start_time;
+  auto numEvents = system.getNumEvents();
+  std::vector<double> previous_roots(numEvents);
+  std::vector<double> roots(numEvents);
+  std::vector<double> probe_roots(numEvents);
+  SBMLSystem::state probe(start_state.size());
 
-  // assignment rules
-  system.handleAssignmentRule(start_state, time);
+  // initial assignments and assignment rules, then triggers that already hold (as in the other integrators)
+  system.handleInitialAssignment(start_state, time);
+  system.handleEvent(start_state, time);
+  system.evaluateEventRoots(start_state, time, previous_roots);
 
   // observer
   obs(start_state, time);
 
+  st.initialize(start_state, time, dt);
+  double next_output = start_time + time_step;
+  while (odeint::detail::less_eq_with_sign(next_output, end_time, dt)) {
+    st.do_step(std::ref(system));
+    real_steps++;
+    double step_start = st.previous_time();
+    double step_end = st.current_time();
+
+    // earliest trigger that became true within the step
+    probe = st.current_state();
+    system.evaluateEventRoots(probe, step_end, roots);
+    bool triggered = false;
+    double event_time = step_end;
+    for (unsigned int i = 0; i < numEvents; i++) {
+      if (previous_roots[i] <= 0.0 && roots[i] > 0.0) {
+        auto t = detail::locate_event(st, system, i, step_start, previous_roots[i], step_end, roots[i], probe,
+                                      probe_roots);
+        if (!triggered || t < event_time) {
+          event_time = t;
+        }
+        triggered = true;
+      }
+    }
+
+    // outputs within the step, up to the event
+    double output_limit = triggered ? event_time - detail::event_time_tolerance(event_time) : step_end;
+    while (odeint::detail::less_eq_with_sign(next_output, end_time, dt)
+        && odeint::detail::less_eq_with_sign(next_output, output_limit, dt)) {
+      step++;
+      time = next_output;
+      st.calc_state(time, start_state);
+      system.handleAssignmentRule(start_state, time);
+      obs(start_state, time);
+      next_output = start_time + static_cast<typename odeint::unit_value_type<double>::type>(step + 1) * time_step;
+    }
+
+    if (!triggered) {
+      previous_roots.swap(roots);
+      continue;
+    }
+
+    // execute every event triggered at event_time (the triggers held at the start of the step are latched)
+    // and restart from there
+    st.calc_state(event_time, probe);
+    system.handleAssignmentRule(probe, event_time);
+    system.setEventTriggerStates(previous_roots);
+    system.handleEvent(probe, event_time);
+    system.evaluateEventRoots(probe, event_time, previous_roots);
+    st.initialize(probe, event_time, st.current_time_step());
+
+    // an output point at the event time shows the values after the event
+    while (odeint::detail::less_eq_with_sign(next_output, end_time, dt)
+        && odeint::detail::less_eq_with_sign(next_output, event_time + detail::event_time_tolerance(event_time), dt)) {
+      step++;
+      time = next_output;
+      start_state = probe;
+      obs(start_state, time);
+      next_output = start_time + static_cast<typename odeint::unit_value_type<double>::type>(step + 1) * time_step;
+    }
+  }
+
   return real_steps;
 }
 
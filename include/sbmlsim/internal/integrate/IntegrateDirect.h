@@ -0,0 +1,151 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEDIRECT_H_
+#define INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEDIRECT_H_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <boost/numeric/odeint.hpp>
+#include "sbmlsim/internal/system/SBMLSystem.h"
+#include "sbmlsim/internal/util/RuntimeExceptionUtil.h"
+
+using namespace boost::numeric;
+
+namespace sbmlsim {
+
+struct SSAStatistics {
+  unsigned long numFirings;
+  unsigned long numOutputPoints;
+};
+
+namespace detail {
+
+// uniform on (0, 1) from the upper 53 bits of a 64-bit engine (e.g. std::mt19937_64)
+template<class Random>
+inline double random_uniform(Random &random) {
+  return (static_cast<double>(random() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// waiting time to the next firing for total propensity a0 (infinite when nothing can fire)
+template<class Random>
+inline double random_waiting_time(Random &random, double a0) {
+  if (a0 <= 0.0) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return -std::log(random_uniform(random)) / a0;
+}
+
+inline void check_propensity(double propensity) {
+  if (!(propensity >= 0.0) || std::isinf(propensity)) {
+    RuntimeExceptionUtil::throwIntegrationException("negative or undefined propensity");
+  }
+}
+
+/*
+ * Output points of a stochastic run before `time`. The state is piecewise
+ * constant, so each point shows x as it was after the last firing. `step`
+ * counts the points already observed. With `events`, triggers are also
+ * checked at every point, so an event on time fires there even when nothing
+ * can fire: the point is observed after the event and the run stops there
+ * (returns true with `event_time`), as the drawn firing no longer applies.
+ */
+template<class Observer>
+bool observe_until(SBMLSystem &system, SBMLSystem::state &x, double start_time, double end_time, double dt,
+                   double time, unsigned long &step, Observer &obs, unsigned long &numOutputPoints,
+                   bool events, double &event_time) {
+  while (true) {
+    double tout = start_time + static_cast<double>(step) * dt;
+    if (!odeint::detail::less_eq_with_sign(tout, end_time, dt) || !odeint::detail::less_with_sign(tout, time, dt)) {
+      return false;
+    }
+    system.handleAssignmentRule(x, tout);
+    bool fired = events && system.handleEvent(x, tout);
+    obs(x, tout);
+    numOutputPoints++;
+    step++;
+    if (fired) {
+      event_time = tout;
+      return true;
+    }
+  }
+}
+
+// first reaction whose partial propensity sum exceeds r in [0, a0) (never one that cannot fire)
+inline unsigned int select_reaction(const std::vector<double> &propensities, double r) {
+  unsigned int j = 0;
+  double sum = propensities[0];
+  while (sum <= r && j + 1 < propensities.size()) {
+    sum += propensities[++j];
+  }
+  while (propensities[j] == 0.0) {
+    j--;
+  }
+  return j;
+}
+
+} /* namespace detail */
+
+/*
+ * Gillespie's direct method on the same output grid as integrate_const().
+ * Every reaction is a jump by its column of the stoichiometry matrix with the
+ * kinetic law as propensity; after each firing all propensities are
+ * recomputed, the waiting time is drawn from their sum and the reaction by
+ * linear search. Events are checked after every firing and at every output
+ * point, so a trigger on time fires at the first output point it holds even
+ * while nothing can fire (not at its exact time). Kinetic laws that read time
+ * are evaluated at the last firing or event and held until the next one: the
+ * waiting time does not account for propensities changing in between.
+ */
+template<class Random, class Observer>
+SSAStatistics integrate_direct(
+    SBMLSystem &system, SBMLSystem::state &start_state, double start_time, double end_time, double dt,
+    Random &random, Observer observer) {
+  typename odeint::unwrap_reference<Observer>::type &obs = observer;
+
+  SSAStatistics statistics = {};
+  auto numReactions = system.getNumReactions();
+  std::vector<double> propensities(numReactions);
+  bool hasEvents = system.getNumEvents() > 0;
+  double time = start_time;
+  unsigned long step = 0;
+
+  // initial assignments and assignment rules
+  system.handleInitialAssignment(start_state, time);
+  if (hasEvents) {
+    system.handleEvent(start_state, time);
+  }
+
+  while (odeint::detail::less_eq_with_sign(start_time + static_cast<double>(step) * dt, end_time, dt)) {
+    system.evaluatePropensities(start_state, time, propensities);
+    double a0 = 0.0;
+    for (auto propensity : propensities) {
+      detail::check_propensity(propensity);
+      a0 += propensity;
+    }
+    double next_time = time + detail::random_waiting_time(random, a0);
+
+    // observer, and events at the output points
+    if (detail::observe_until(system, start_state, start_time, end_time, dt, next_time, step, obs,
+                              statistics.numOutputPoints, hasEvents, time)) {
+      continue;
+    }
+    if (!odeint::detail::less_eq_with_sign(next_time, end_time, dt)) {
+      break;
+    }
+
+    auto j = detail::select_reaction(propensities, detail::random_uniform(random) * a0);
+    time = next_time;
+    system.fireReaction(j, start_state, time);
+    statistics.numFirings++;
+
+    // event
+    if (hasEvents) {
+      system.handleEvent(start_state, time);
+    }
+  }
+
+  return statistics;
+}
+
+} /* namespace sbmlsim */
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEDIRECT_H_ */
@@ -0,0 +1,120 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEENSEMBLE_H_
+#define INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEENSEMBLE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "sbmlsim/config/RunConfiguration.h"
+#include "sbmlsim/internal/integrate/IntegrateCompositionRejection.h"
+#include "sbmlsim/internal/integrate/IntegrateDirect.h"
+#include "sbmlsim/internal/integrate/IntegrateNextReaction.h"
+#include "sbmlsim/internal/integrate/IntegrateTauLeaping.h"
+#include "sbmlsim/internal/random/PhiloxEngine.h"
+#include "sbmlsim/internal/system/SBMLSystem.h"
+#include "sbmlsim/internal/util/RuntimeExceptionUtil.h"
+
+namespace sbmlsim {
+
+struct EnsembleStatistics {
+  unsigned long numTrajectories;
+  unsigned long numFirings;
+  unsigned int numThreads;
+};
+
+namespace detail {
+
+// one trajectory with the given stochastic method; returns the number of firings
+template<class Random, class Observer>
+unsigned long integrate_trajectory(SBMLSystem &system, SBMLSystem::state &x, IntegratorType method,
+                                   double start_time, double end_time, double dt, Random &random, Observer &obs) {
+  switch (method) {
+    case IntegratorType::GILLESPIE_DIRECT:
+      return integrate_direct(system, x, start_time, end_time, dt, random, std::ref(obs)).numFirings;
+    case IntegratorType::GILLESPIE_NEXT_REACTION:
+      return integrate_next_reaction(system, x, start_time, end_time, dt, random, std::ref(obs)).numFirings;
+    case IntegratorType::GILLESPIE_COMPOSITION_REJECTION:
+      return integrate_composition_rejection(system, x, start_time, end_time, dt, random, std::ref(obs)).numFirings;
+    case IntegratorType::TAU_LEAPING:
+      return integrate_tau_leaping(system, x, start_time, end_time, dt, TAU_LEAPING_EPSILON, random,
+                                   std::ref(obs)).numFirings;
+    default:
+      RuntimeExceptionUtil::throwIntegrationException("ensembles need a stochastic integrator");
+  }
+  return 0;
+}
+
+} /* namespace detail */
+
+/*
+ * Runs numTrajectories independent stochastic trajectories of `system` on
+ * numThreads threads (0: one per hardware thread). Every trajectory works on
+ * its own copy of `system`, starts from its initial state and draws from
+ * PhiloxEngine(seed, trajectory), so trajectory k comes out the same for any
+ * thread count and scheduling. Threads take the next trajectory index from a
+ * shared counter. The observer is called as
+ * observer(worker, trajectory, trajectorySystem, x, t) from the worker threads
+ * concurrently; worker (< numThreads) is there to keep per-thread results
+ * apart (see EnsembleStatisticsObserver). A trajectory that throws stops the ensemble;
+ * the exception is rethrown once all threads have stopped.
+ */
+template<class Observer>
+EnsembleStatistics integrate_ensemble(
+    const SBMLSystem &system, IntegratorType method, double start_time, double end_time, double dt,
+    unsigned long numTrajectories, unsigned long seed, unsigned int numThreads, Observer observer) {
+  typename odeint::unwrap_reference<Observer>::type &obs = observer;
+
+  if (numThreads == 0) {
+    numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  numThreads = static_cast<unsigned int>(std::max(std::min<unsigned long>(numThreads, numTrajectories), 1ul));
+
+  std::atomic<unsigned long> next(0);
+  std::atomic<unsigned long> numFirings(0);
+  std::atomic<bool> failed(false);
+  std::vector<std::exception_ptr> errors(numThreads);
+  auto work = [&](unsigned int worker) {
+    try {
+      for (auto trajectory = next++; trajectory < numTrajectories && !failed; trajectory = next++) {
+        SBMLSystem trajectorySystem(system);
+        auto x = trajectorySystem.getInitialState();
+        PhiloxEngine random(seed, trajectory);
+        auto trajectoryObserver = [&obs, &trajectorySystem, worker, trajectory](const SBMLSystem::state &x,
+                                                                                double t) {
+          obs(worker, trajectory, trajectorySystem, x, t);
+        };
+        numFirings += detail::integrate_trajectory(trajectorySystem, x, method, start_time, end_time, dt, random,
+                                                   trajectoryObserver);
+      }
+    } catch (...) {
+      errors[worker] = std::current_exception();
+      failed = true;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int worker = 1; worker < numThreads; worker++) {
+    threads.emplace_back(work, worker);
+  }
+  work(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  EnsembleStatistics statistics = {};
+  statistics.numTrajectories = numTrajectories;
+  statistics.numFirings = numFirings;
+  statistics.numThreads = numThreads;
+  return statistics;
+}
+
+} /* namespace sbmlsim */
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATEENSEMBLE_H_ */
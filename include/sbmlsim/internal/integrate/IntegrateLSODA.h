@@ -0,0 +1,136 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATELSODA_H_
+#define INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATELSODA_H_
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <boost/numeric/odeint.hpp>
+#include "sbmlsim/internal/system/SBMLSystem.h"
+#include "sbmlsim/internal/thirdparty/liblsoda.h"
+
+using namespace boost::numeric;
+
+namespace sbmlsim {
+
+/*
+ * Result of integrate_lsoda(). state and error are taken from lsoda_context_t
+ * after the last call (state <= 0 means LSODA failed, error tells why); the
+ * counters are collected around it.
+ */
+struct LSODAStatistics {
+  int state;
+  std::string error;
+  unsigned long numOutputPoints;
+  unsigned long numFunctionEvaluations;
+  unsigned long numRestarts;  // after events changed the state or the parameter block
+};
+
+namespace detail {
+
+struct LSODAData {
+  SBMLSystem *system;
+  unsigned long numFunctionEvaluations;
+};
+
+// RHS callback: LSODA's buffers are passed to the system as they are
+inline int lsoda_function(double t, double *y, double *ydot, void *data) {
+  auto lsodaData = static_cast<LSODAData *>(data);
+  (*lsodaData->system)(y, ydot, t);
+  lsodaData->numFunctionEvaluations++;
+  return 0;
+}
+
+} /* namespace detail */
+
+/*
+ * Same loop as integrate_const(), with LSODA (automatic switching between
+ * Adams and BDF) integrating in place on start_state between output points.
+ * rtol and atol hold one tolerance per state variable.
+ */
+template<class Observer>
+LSODAStatistics integrate_lsoda(
+    SBMLSystem &system, SBMLSystem::state &start_state, double start_time, double end_time, double dt,
+    std::vector<double> &rtol, std::vector<double> &atol, Observer observer) {
+  typename odeint::unwrap_reference<Observer>::type &obs = observer;
+
+  LSODAStatistics statistics = {};
+  detail::LSODAData data = {&system, 0};
+  int neq = start_state.size();
+  double *y = start_state.data().begin();
+
+  lsoda_opt_t opt = {};
+  opt.ixpr = 0;
+  opt.rtol = rtol.data();
+  opt.atol = atol.data();
+  // itask 4: output by interpolation at tout, but never step past the end of the run
+  opt.itask = 4;
+  opt.tcrit = end_time;
+
+  lsoda_context_t ctx = {};
+  ctx.function = detail::lsoda_function;
+  ctx.neq = neq;
+  ctx.data = &data;
+  ctx.state = 1;
+  if (neq > 0) {
+    lsoda_prepare(&ctx, &opt);
+  }
+
+  double time = start_time;
+  int step = 0;
+  SBMLSystem::state previousState(neq);
+  std::vector<double> previousParameters;
+
+  // initial assignments and assignment rules, then triggers that already hold
+  system.handleInitialAssignment(start_state, time);
+  if (system.handleEvent(start_state, time)) {
+    system.handleAssignmentRule(start_state, time);
+  }
+
+  while (odeint::detail::less_eq_with_sign(time + dt, end_time, dt)) {
+    // observer
+    obs(start_state, time);
+    statistics.numOutputPoints++;
+
+    step++;
+    double tout = start_time + static_cast<double>(step) * dt;
+    if (neq > 0) {
+      lsoda(&ctx, y, &time, tout);
+      if (ctx.state <= 0) {
+        break;
+      }
+    }
+    time = tout;
+
+    // event; a discontinuity invalidates LSODA's history, so it restarts from the new values
+    previousState = start_state;
+    previousParameters = system.getParameterValues();
+    system.handleEvent(start_state, time);
+    if (!std::equal(start_state.begin(), start_state.end(), previousState.begin())
+        || system.getParameterValues() != previousParameters) {
+      ctx.state = 1;
+      statistics.numRestarts++;
+    }
+
+    // assignment rules
+    system.handleAssignmentRule(start_state, time);
+  }
+
+  statistics.state = ctx.state;
+  statistics.numFunctionEvaluations = data.numFunctionEvaluations;
+  if (ctx.state <= 0) {
+    statistics.error = ctx.error != NULL ? ctx.error : "unknown error";
+  } else {
+    // observer
+    obs(start_state, time);
+    statistics.numOutputPoints++;
+  }
+
+  if (neq > 0) {
+    lsoda_free(&ctx);
+  }
+  return statistics;
+}
+
+} /* namespace sbmlsim */
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATELSODA_H_ */
@@ -0,0 +1,128 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATENEXTREACTION_H_
+#define INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATENEXTREACTION_H_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <boost/numeric/odeint.hpp>
+#include "sbmlsim/internal/integrate/IntegrateDirect.h"
+#include "sbmlsim/internal/system/DependencyGraph.h"
+#include "sbmlsim/internal/system/IndexedPriorityQueue.h"
+#include "sbmlsim/internal/system/SBMLSystem.h"
+
+using namespace boost::numeric;
+
+namespace sbmlsim {
+
+namespace detail {
+
+// all propensities and a fresh putative firing time for every reaction
+template<class Random>
+void draw_firing_times(SBMLSystem &system, const SBMLSystem::state &x, double t, Random &random,
+                       std::vector<double> &propensities, std::vector<double> &times, IndexedPriorityQueue &queue) {
+  system.evaluatePropensities(x, t, propensities);
+  for (unsigned int i = 0; i < propensities.size(); i++) {
+    check_propensity(propensities[i]);
+    times[i] = t + random_waiting_time(random, propensities[i]);
+  }
+  queue.build(times);
+}
+
+} /* namespace detail */
+
+/*
+ * Gibson and Bruck's next reaction method: same results and output as
+ * integrate_direct(), but every reaction keeps an absolute putative firing
+ * time in an indexed priority queue. After reaction j fires only the
+ * reactions reading what j changed (SBMLSystem::getReactionDependencyGraph())
+ * are re-evaluated; their remaining waiting times are rescaled by
+ * old / new propensity, and only j draws a new one. A firing then costs
+ * O(log R) for R reactions. Events that change anything restart all clocks.
+ */
+template<class Random, class Observer>
+SSAStatistics integrate_next_reaction(
+    SBMLSystem &system, SBMLSystem::state &start_state, double start_time, double end_time, double dt,
+    Random &random, Observer observer) {
+  typename odeint::unwrap_reference<Observer>::type &obs = observer;
+
+  SSAStatistics statistics = {};
+  auto numReactions = system.getNumReactions();
+  auto &dependencies = system.getReactionDependencyGraph();
+  std::vector<double> propensities(numReactions);
+  std::vector<double> previous(numReactions);
+  std::vector<double> times(numReactions);
+  IndexedPriorityQueue queue(numReactions);
+  bool hasEvents = system.getNumEvents() > 0;
+  SBMLSystem::state previousState(start_state.size());
+  std::vector<double> previousParameters;
+  double time = start_time;
+  unsigned long step = 0;
+
+  // initial assignments and assignment rules
+  system.handleInitialAssignment(start_state, time);
+  if (hasEvents) {
+    system.handleEvent(start_state, time);
+  }
+  detail::draw_firing_times(system, start_state, time, random, propensities, times, queue);
+
+  while (odeint::detail::less_eq_with_sign(start_time + static_cast<double>(step) * dt, end_time, dt)) {
+    double next_time = numReactions > 0 ? queue.getTopKey() : std::numeric_limits<double>::infinity();
+
+    // observer, and events at the output points
+    if (detail::observe_until(system, start_state, start_time, end_time, dt, next_time, step, obs,
+                              statistics.numOutputPoints, hasEvents, time)) {
+      detail::draw_firing_times(system, start_state, time, random, propensities, times, queue);
+      continue;
+    }
+    if (!odeint::detail::less_eq_with_sign(next_time, end_time, dt)) {
+      break;
+    }
+
+    auto j = queue.getTop();
+    time = next_time;
+    system.fireReaction(j, start_state, time);
+    statistics.numFirings++;
+
+    // event
+    if (hasEvents) {
+      previousState = start_state;
+      previousParameters = system.getParameterValues();
+      system.handleEvent(start_state, time);
+      if (!std::equal(start_state.begin(), start_state.end(), previousState.begin())
+          || system.getParameterValues() != previousParameters) {
+        detail::draw_firing_times(system, start_state, time, random, propensities, times, queue);
+        continue;
+      }
+    }
+
+    // propensities that read what j changed
+    auto &affected = dependencies.getSuccessors(j);
+    for (auto i : affected) {
+      previous[i] = propensities[i];
+    }
+    system.evaluatePropensities(start_state, time, affected, propensities);
+    for (auto i : affected) {
+      detail::check_propensity(propensities[i]);
+      if (i == j) {
+        continue;
+      }
+      double key;
+      if (propensities[i] == 0.0) {
+        key = std::numeric_limits<double>::infinity();
+      } else if (previous[i] > 0.0) {
+        key = time + previous[i] / propensities[i] * (queue.getKey(i) - time);
+      } else {
+        key = time + detail::random_waiting_time(random, propensities[i]);
+      }
+      queue.update(i, key);
+    }
+    queue.update(j, time + detail::random_waiting_time(random, propensities[j]));
+  }
+
+  return statistics;
+}
+
+} /* namespace sbmlsim */
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATENEXTREACTION_H_ */
@@ -0,0 +1,301 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATETAULEAPING_H_
+#define INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATETAULEAPING_H_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <boost/numeric/odeint.hpp>
+#include "sbmlsim/internal/integrate/IntegrateDirect.h"
+#include "sbmlsim/internal/system/SBMLSystem.h"
+#include "sbmlsim/internal/system/StoichiometryMatrix.h"
+
+using namespace boost::numeric;
+
+// default bound on the relative change of propensities within a leap
+#define TAU_LEAPING_EPSILON 0.03
+// reactions that can fire fewer times than this before exhausting a reactant are critical
+#define CRITICAL_REACTION_THRESHOLD 10
+// leaps shorter than this many expected exact steps are replaced by exact steps ...
+#define EXACT_STEP_FACTOR 10.0
+// ... this many of them
+#define NUM_EXACT_STEPS 100
+
+namespace sbmlsim {
+
+struct TauLeapingStatistics {
+  unsigned long numFirings;
+  unsigned long numOutputPoints;
+  unsigned long numLeaps;
+  unsigned long numRejectedLeaps;  // halved because a population would have turned negative
+  unsigned long numExactSteps;
+};
+
+namespace detail {
+
+/*
+ * Poisson variate with the given mean: multiplication of uniforms for small
+ * means, Hoermann's transformed rejection (PTRS) otherwise. Written out
+ * instead of std::poisson_distribution so that a seed gives the same result
+ * with every standard library.
+ */
+template<class Random>
+double random_poisson(Random &random, double mean) {
+  if (mean <= 0.0) {
+    return 0.0;
+  }
+  if (mean < 10.0) {
+    double limit = std::exp(-mean);
+    double product = random_uniform(random);
+    double k = 0.0;
+    while (product > limit) {
+      product *= random_uniform(random);
+      k += 1.0;
+    }
+    return k;
+  }
+  double sqrtMean = std::sqrt(mean);
+  double logMean = std::log(mean);
+  double b = 0.931 + 2.53 * sqrtMean;
+  double a = -0.059 + 0.02483 * b;
+  double inverseAlpha = 1.1239 + 1.1328 / (b - 3.4);
+  double vr = 0.9277 - 3.6224 / (b - 2.0);
+  while (true) {
+    double u = random_uniform(random) - 0.5;
+    double v = random_uniform(random);
+    double us = 0.5 - std::fabs(u);
+    double k = std::floor((2.0 * a / us + b) * u + mean + 0.43);
+    if (us >= 0.07 && v <= vr) {
+      return k;
+    }
+    if (k < 0.0 || (us < 0.013 && v > us)) {
+      continue;
+    }
+    if (std::log(v) + std::log(inverseAlpha) - std::log(a / (us * us) + b)
+        <= -mean + k * logMean - std::lgamma(k + 1.0)) {
+      return k;
+    }
+  }
+}
+
+/*
+ * Highest order reaction of every species (Cao, Gillespie and Petzold):
+ * `orders` holds the largest molecularity among the reactions consuming it
+ * and `multiplicities` how many molecules of it such a reaction takes.
+ */
+inline void highest_order_reactions(const StoichiometryMatrix &reactants, std::vector<double> &orders,
+                                    std::vector<double> &multiplicities) {
+  auto &columnPointers = reactants.getColumnPointers();
+  auto &rowIndices = reactants.getRowIndices();
+  auto &columnValues = reactants.getColumnValues();
+  orders.assign(reactants.getNumRows(), 0.0);
+  multiplicities.assign(reactants.getNumRows(), 0.0);
+  for (unsigned int j = 0; j < reactants.getNumColumns(); j++) {
+    double order = 0.0;
+    for (auto k = columnPointers[j]; k < columnPointers[j + 1]; k++) {
+      order += columnValues[k];
+    }
+    for (auto k = columnPointers[j]; k < columnPointers[j + 1]; k++) {
+      auto i = rowIndices[k];
+      if (order > orders[i] || (order == orders[i] && columnValues[k] > multiplicities[i])) {
+        orders[i] = order;
+        multiplicities[i] = columnValues[k];
+      }
+    }
+  }
+}
+
+// g_i: the relative change of x_i that keeps every propensity within a relative change of epsilon
+inline double propensity_sensitivity(double order, double multiplicity, double x) {
+  double x1 = std::max(x - 1.0, 1.0);
+  double x2 = std::max(x - 2.0, 1.0);
+  if (order <= 1.0) {
+    return 1.0;
+  }
+  if (order == 2.0) {
+    return multiplicity >= 2.0 ? 2.0 + 1.0 / x1 : 2.0;
+  }
+  if (order == 3.0) {
+    if (multiplicity >= 3.0) {
+      return 3.0 + 1.0 / x1 + 2.0 / x2;
+    }
+    return multiplicity == 2.0 ? 1.5 * (2.0 + 1.0 / x1) : 3.0;
+  }
+  return order;
+}
+
+} /* namespace detail */
+
+/*
+ * Explicit tau-leaping with the step size selection of Cao, Gillespie and
+ * Petzold (2006), on the same output grid as integrate_direct(). Each leap
+ * fires every non-critical reaction a Poisson-distributed number of times,
+ * with tau bounded so that the expected relative change of any propensity
+ * stays below epsilon. Critical reactions (those fewer than
+ * CRITICAL_REACTION_THRESHOLD firings away from exhausting a reactant, and
+ * reactions with stoichiometryMath) fire at most once per leap, chosen
+ * exactly as in the direct method. A leap that would make a population
+ * negative is retried with half the step. Once tau falls below
+ * EXACT_STEP_FACTOR / a0 the next NUM_EXACT_STEPS steps are exact SSA steps.
+ * Leaps never cross an output point. Events are checked after every step and
+ * at every output point; propensities are held over a step as in
+ * integrate_direct().
+ */
+template<class Random, class Observer>
+TauLeapingStatistics integrate_tau_leaping(
+    SBMLSystem &system, SBMLSystem::state &start_state, double start_time, double end_time, double dt,
+    double epsilon, Random &random, Observer observer) {
+  typename odeint::unwrap_reference<Observer>::type &obs = observer;
+  const double infinity = std::numeric_limits<double>::infinity();
+
+  TauLeapingStatistics statistics = {};
+  auto numReactions = system.getNumReactions();
+  auto numStates = start_state.size();
+  auto &stoichiometry = system.getStoichiometryMatrix();
+  auto &columnPointers = stoichiometry.getColumnPointers();
+  auto &rowIndices = stoichiometry.getRowIndices();
+  auto &columnValues = stoichiometry.getColumnValues();
+  std::vector<double> orders;
+  std::vector<double> multiplicities;
+  detail::highest_order_reactions(system.getReactantMatrix(), orders, multiplicities);
+  std::vector<bool> variable(numReactions);
+  for (unsigned int j = 0; j < numReactions; j++) {
+    variable[j] = system.hasVariableStoichiometry(j);
+  }
+
+  std::vector<double> propensities(numReactions);
+  std::vector<double> criticalPropensities(numReactions);
+  std::vector<bool> critical(numReactions);
+  std::vector<double> counts(numReactions);
+  std::vector<double> mu(numStates);
+  std::vector<double> sigma2(numStates);
+  SBMLSystem::state candidate(numStates);
+  bool hasEvents = system.getNumEvents() > 0;
+  double time = start_time;
+  unsigned long step = 0;
+  unsigned int exactSteps = 0;
+
+  // initial assignments and assignment rules
+  system.handleInitialAssignment(start_state, time);
+  if (hasEvents) {
+    system.handleEvent(start_state, time);
+  }
+
+  while (odeint::detail::less_eq_with_sign(start_time + static_cast<double>(step) * dt, end_time, dt)) {
+    system.evaluatePropensities(start_state, time, propensities);
+    double a0 = 0.0;
+    for (auto propensity : propensities) {
+      detail::check_propensity(propensity);
+      a0 += propensity;
+    }
+
+    // critical reactions, and the leap bound from the non-critical ones
+    double criticalA0 = 0.0;
+    std::fill(mu.begin(), mu.end(), 0.0);
+    std::fill(sigma2.begin(), sigma2.end(), 0.0);
+    for (unsigned int j = 0; j < numReactions; j++) {
+      double firings = infinity;
+      for (auto k = columnPointers[j]; k < columnPointers[j + 1]; k++) {
+        if (columnValues[k] < 0.0) {
+          firings = std::min(firings, std::floor(start_state[rowIndices[k]] / -columnValues[k]));
+        }
+      }
+      critical[j] = propensities[j] > 0.0 && (variable[j] || firings < CRITICAL_REACTION_THRESHOLD);
+      criticalPropensities[j] = critical[j] ? propensities[j] : 0.0;
+      criticalA0 += criticalPropensities[j];
+      if (critical[j] || propensities[j] == 0.0) {
+        continue;
+      }
+      for (auto k = columnPointers[j]; k < columnPointers[j + 1]; k++) {
+        mu[rowIndices[k]] += columnValues[k] * propensities[j];
+        sigma2[rowIndices[k]] += columnValues[k] * columnValues[k] * propensities[j];
+      }
+    }
+    double leap = infinity;
+    for (unsigned int i = 0; i < numStates; i++) {
+      if (orders[i] == 0.0 || sigma2[i] == 0.0) {
+        continue;
+      }
+      double bound = std::max(epsilon * start_state[i]
+                              / detail::propensity_sensitivity(orders[i], multiplicities[i], start_state[i]), 1.0);
+      leap = std::min(leap, std::min(bound / std::fabs(mu[i]), bound * bound / sigma2[i]));
+    }
+
+    // exact steps while leaping does not pay off
+    if (exactSteps == 0 && a0 > 0.0 && leap < EXACT_STEP_FACTOR / a0) {
+      exactSteps = NUM_EXACT_STEPS;
+    }
+    if (exactSteps > 0 || a0 == 0.0) {
+      double next_time = time + detail::random_waiting_time(random, a0);
+      if (detail::observe_until(system, start_state, start_time, end_time, dt, next_time, step, obs,
+                                statistics.numOutputPoints, hasEvents, time)) {
+        continue;
+      }
+      if (!odeint::detail::less_eq_with_sign(next_time, end_time, dt)) {
+        break;
+      }
+      auto j = detail::select_reaction(propensities, detail::random_uniform(random) * a0);
+      time = next_time;
+      system.fireReaction(j, start_state, time);
+      statistics.numFirings++;
+      statistics.numExactSteps++;
+      if (exactSteps > 0) {
+        exactSteps--;
+      }
+    } else {
+      // an output point just reached is observed first; the next one bounds the leap
+      double next_output = start_time + static_cast<double>(step) * dt;
+      if (odeint::detail::less_eq_with_sign(next_output, time, dt)) {
+        system.handleAssignmentRule(start_state, next_output);
+        obs(start_state, next_output);
+        statistics.numOutputPoints++;
+        step++;
+        next_output = start_time + static_cast<double>(step) * dt;
+        if (!odeint::detail::less_eq_with_sign(next_output, end_time, dt)) {
+          break;
+        }
+      }
+      while (true) {
+        double criticalTime = detail::random_waiting_time(random, criticalA0);
+        double tau = std::min(std::min(leap, criticalTime), next_output - time);
+        std::fill(counts.begin(), counts.end(), 0.0);
+        if (tau == criticalTime) {
+          counts[detail::select_reaction(criticalPropensities, detail::random_uniform(random) * criticalA0)] = 1.0;
+        }
+        for (unsigned int j = 0; j < numReactions; j++) {
+          if (!critical[j]) {
+            counts[j] = detail::random_poisson(random, propensities[j] * tau);
+          }
+        }
+        candidate = start_state;
+        for (unsigned int j = 0; j < numReactions; j++) {
+          if (counts[j] > 0.0) {
+            system.fireReaction(j, candidate, time, counts[j]);
+          }
+        }
+        if (std::all_of(candidate.begin(), candidate.end(), [](double value) { return value >= 0.0; })) {
+          start_state = candidate;
+          time = tau == next_output - time ? next_output : time + tau;
+          for (auto count : counts) {
+            statistics.numFirings += static_cast<unsigned long>(count);
+          }
+          statistics.numLeaps++;
+          break;
+        }
+        statistics.numRejectedLeaps++;
+        leap = 0.5 * tau;
+      }
+    }
+
+    // event
+    if (hasEvents) {
+      system.handleEvent(start_state, time);
+    }
+  }
+
+  return statistics;
+}
+
+} /* namespace sbmlsim */
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_INTEGRATE_INTEGRATETAULEAPING_H_ */
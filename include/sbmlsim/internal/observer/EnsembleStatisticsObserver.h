@@ -0,0 +1,55 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_OBSERVER_ENSEMBLESTATISTICSOBSERVER_H_
+#define INCLUDE_SBMLSIM_INTERNAL_OBSERVER_ENSEMBLESTATISTICSOBSERVER_H_
+
+#include <vector>
+#include "sbmlsim/internal/observer/ObserveTarget.h"
+#include "sbmlsim/internal/statistics/QuantileSketch.h"
+#include "sbmlsim/internal/statistics/RunningStatistics.h"
+#include "sbmlsim/internal/system/SBMLSystem.h"
+
+/*
+ * Observer for integrate_ensemble() that folds every output point of every
+ * trajectory into per time point, per target running statistics and a
+ * quantile sketch (sketchCapacity 0: no quantiles) instead of keeping the
+ * trajectories. Each worker thread has accumulators of its own, so memory is
+ * workers * time points * targets * sketch size, where a sketch holds about
+ * 3 * sketchCapacity values and grows only with the logarithm of the number
+ * of trajectories (see QuantileSketch). merge() combines the accumulators
+ * into those of the first worker and frees the others once the ensemble is
+ * done, after which the getters report the whole ensemble. Merged results
+ * do not depend on the thread count except for rounding and the sketch
+ * error.
+ */
+class EnsembleStatisticsObserver {
+ public:
+  // numWorkers as passed to integrate_ensemble() (0: one per hardware thread)
+  EnsembleStatisticsObserver(const std::vector<ObserveTarget> &targets, unsigned int numWorkers,
+                             unsigned int sketchCapacity = QUANTILE_SKETCH_CAPACITY);
+  EnsembleStatisticsObserver(const EnsembleStatisticsObserver &observer);
+  ~EnsembleStatisticsObserver();
+  void operator()(unsigned int worker, unsigned long trajectory, const SBMLSystem &system,
+                  const SBMLSystem::state &x, double t);
+  void merge();
+  const std::vector<ObserveTarget> &getTargets() const;
+  unsigned long getNumTimePoints() const;
+  double getTime(unsigned long timeIndex) const;
+  const RunningStatistics &getStatistics(unsigned long timeIndex, unsigned int targetIndex) const;
+  const QuantileSketch &getQuantiles(unsigned long timeIndex, unsigned int targetIndex) const;
+ private:
+  struct Accumulator {
+    explicit Accumulator(unsigned int sketchCapacity) : quantiles(sketchCapacity) {}
+    RunningStatistics statistics;
+    QuantileSketch quantiles;
+  };
+  struct Worker {
+    unsigned long trajectory;  // the trajectory being observed ...
+    unsigned long position;    // ... and its next time point
+    std::vector<double> times;
+    std::vector<Accumulator> accumulators;  // one per target for each time point
+  };
+  std::vector<ObserveTarget> targets;
+  unsigned int sketchCapacity;
+  std::vector<Worker> workers;  // workers[0] holds the merged results
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_OBSERVER_ENSEMBLESTATISTICSOBSERVER_H_ */
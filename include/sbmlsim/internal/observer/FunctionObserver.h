@@ -0,0 +1,25 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_OBSERVER_FUNCTIONOBSERVER_H_
+#define INCLUDE_SBMLSIM_INTERNAL_OBSERVER_FUNCTIONOBSERVER_H_
+
+#include <functional>
+#include <vector>
+#include "sbmlsim/internal/system/SBMLSystem.h"
+#include "sbmlsim/internal/observer/ObserveTarget.h"
+
+// hands the values of the targets at each output point to a caller-supplied function
+class FunctionObserver {
+ public:
+  using Function = std::function<void(double, const std::vector<double> &)>;
+ public:
+  FunctionObserver(const std::vector<ObserveTarget> &targets, const SBMLSystem *system, const Function &function);
+  FunctionObserver(const FunctionObserver &observer);
+  ~FunctionObserver();
+  void operator()(const SBMLSystem::state &x, double t);
+ private:
+  std::vector<ObserveTarget> targets;
+  const SBMLSystem *system;  // parameter block
+  Function function;
+  std::vector<double> values;
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_OBSERVER_FUNCTIONOBSERVER_H_ */
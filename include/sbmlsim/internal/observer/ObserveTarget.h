@@ -5,14 +5,16 @@
 
 class ObserveTarget {
  public:
-  ObserveTarget(const std::string &id, unsigned int stateIndex);
+  ObserveTarget(const std::string &id, unsigned int stateIndex, bool parameter = false);
   ObserveTarget(const ObserveTarget &observeTarget);
   ~ObserveTarget();
   const std::string &getId() const;
   unsigned int getStateIndex() const;
+  bool isParameter() const;
  private:
   const std::string id;
-  const unsigned int stateIndex;
+  const unsigned int stateIndex;  // index into the parameter block if parameter is set
+  const bool parameter;
 };
 
 #endif /* INCLUDE_SBMLSIM_INTERNAL_OBSERVER_OBSERVETARGET_H_ */
@@ -7,7 +7,7 @@
 
 class StdoutCsvObserver {
  public:
-  explicit StdoutCsvObserver(const std::vector<ObserveTarget> &targets);
+  StdoutCsvObserver(const std::vector<ObserveTarget> &targets, const SBMLSystem *system);
   StdoutCsvObserver(const StdoutCsvObserver &observer);
   ~StdoutCsvObserver();
   void operator()(const SBMLSystem::state &x, double t);
@@ -15,6 +15,7 @@ class StdoutCsvObserver {
   void outputHeader();
  private:
   std::vector<ObserveTarget> targets;
+  const SBMLSystem *system;  // parameter block
 };
 
 #endif /* INCLUDE_SBMLSIM_INTERNAL_OBSERVER_STDOUTCSVOBSERVER_H_ */
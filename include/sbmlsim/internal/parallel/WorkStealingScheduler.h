@@ -0,0 +1,40 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_PARALLEL_WORKSTEALINGSCHEDULER_H_
+#define INCLUDE_SBMLSIM_INTERNAL_PARALLEL_WORKSTEALINGSCHEDULER_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+ * Runs task(worker, index) for every index in [0, numTasks) on numThreads
+ * threads (0: one per hardware thread; the calling thread is worker 0).
+ * Each worker starts on its own contiguous block of indices and takes them
+ * from the front. A worker that runs dry steals the back half of the
+ * largest remaining block of another worker, so a few tasks that take
+ * far longer than the rest keep one worker busy, not the whole run. A task that throws stops the run;
+ * the exception is rethrown once all threads have stopped.
+ */
+class WorkStealingScheduler {
+ public:
+  using Task = std::function<void(unsigned int, unsigned long)>;
+ public:
+  explicit WorkStealingScheduler(unsigned int numThreads);
+  WorkStealingScheduler(const WorkStealingScheduler &scheduler);
+  ~WorkStealingScheduler();
+  unsigned int getNumThreads() const;
+  // returns the number of steals
+  unsigned long run(unsigned long numTasks, const Task &task) const;
+ private:
+  // indices [begin, end) still to be run by one worker
+  struct Block {
+    std::mutex mutex;
+    unsigned long begin;
+    unsigned long end;
+  };
+  unsigned int numThreads;
+  static bool takeFront(Block &block, unsigned long &index);
+  static bool steal(std::vector<std::unique_ptr<Block> > &blocks, unsigned int worker, unsigned long &index);
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_PARALLEL_WORKSTEALINGSCHEDULER_H_ */
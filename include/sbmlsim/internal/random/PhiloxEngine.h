@@ -0,0 +1,91 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_RANDOM_PHILOXENGINE_H_
+#define INCLUDE_SBMLSIM_INTERNAL_RANDOM_PHILOXENGINE_H_
+
+#include <cstdint>
+
+/*
+ * Counter-based random number engine: Philox4x32-10 (Salmon et al.,
+ * "Parallel random numbers: as easy as 1, 2, 3", 2011). The n-th 128-bit
+ * block of stream s under seed k is philox(counter = (n, s), key = k), so
+ * any stream can be started anywhere without generating what comes before,
+ * and (seed, stream) alone decide the sequence, e.g. seed and trajectory
+ * index in an ensemble. Each block yields two 64-bit numbers; usable with
+ * <random> distributions (UniformRandomBitGenerator).
+ */
+class PhiloxEngine {
+ public:
+  using result_type = std::uint64_t;
+ public:
+  PhiloxEngine(result_type seed, result_type stream)
+      : key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)}, stream(stream), block(0),
+        output{0, 0, 0, 0}, position(2) {
+    // nothing to do
+  }
+
+  PhiloxEngine(const PhiloxEngine &engine)
+      : key{engine.key[0], engine.key[1]}, stream(engine.stream), block(engine.block),
+        output{engine.output[0], engine.output[1], engine.output[2], engine.output[3]},
+        position(engine.position) {
+    // nothing to do
+  }
+
+  ~PhiloxEngine() {
+    // nothing to do
+  }
+
+  static constexpr result_type min() {
+    return 0;
+  }
+
+  static constexpr result_type max() {
+    return ~static_cast<result_type>(0);
+  }
+
+  result_type operator()() {
+    if (this->position == 2) {
+      const std::uint32_t counter[4] = {
+          static_cast<std::uint32_t>(this->block), static_cast<std::uint32_t>(this->block >> 32),
+          static_cast<std::uint32_t>(this->stream), static_cast<std::uint32_t>(this->stream >> 32)};
+      generate(counter, this->key, this->output);
+      this->block++;
+      this->position = 0;
+    }
+    auto i = 2 * this->position++;
+    return static_cast<result_type>(this->output[i]) | static_cast<result_type>(this->output[i + 1]) << 32;
+  }
+
+  // the bijection itself: ten rounds over one 128-bit counter
+  static void generate(const std::uint32_t counter[4], const std::uint32_t key[2], std::uint32_t output[4]) {
+    const std::uint32_t M0 = 0xD2511F53;
+    const std::uint32_t M1 = 0xCD9E8D57;
+    const std::uint32_t W0 = 0x9E3779B9;
+    const std::uint32_t W1 = 0xBB67AE85;
+    std::uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    std::uint32_t k0 = key[0], k1 = key[1];
+    for (auto round = 0; round < 10; round++) {
+      std::uint64_t p0 = static_cast<std::uint64_t>(M0) * c0;
+      std::uint64_t p1 = static_cast<std::uint64_t>(M1) * c2;
+      std::uint32_t n0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+      std::uint32_t n2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+      c1 = static_cast<std::uint32_t>(p1);
+      c3 = static_cast<std::uint32_t>(p0);
+      c0 = n0;
+      c2 = n2;
+      k0 += W0;
+      k1 += W1;
+    }
+    output[0] = c0;
+    output[1] = c1;
+    output[2] = c2;
+    output[3] = c3;
+  }
+
+ private:
+  std::uint32_t key[2];
+  result_type stream;
+  result_type block;
+  std::uint32_t output[4];
+  unsigned int position;  // next 64-bit half of output (2: exhausted)
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_RANDOM_PHILOXENGINE_H_ */
@@ -0,0 +1,49 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_STATISTICS_QUANTILESKETCH_H_
+#define INCLUDE_SBMLSIM_INTERNAL_STATISTICS_QUANTILESKETCH_H_
+
+#include <vector>
+
+// values kept on the top level of a QuantileSketch by default
+#define QUANTILE_SKETCH_CAPACITY 200
+
+/*
+ * Mergeable quantile summary of a stream of values (the KLL sketch of
+ * Karnin, Lang and Liberty). A value on level h stands for 2^h input values.
+ * The top level may hold `capacity` values and each level below it 2/3 as
+ * many (at least 2); whenever the sketch holds more than these limits add up
+ * to, the lowest level over its own limit is sorted and every other value
+ * moves up a level, alternating which half is kept. The limits add up to
+ * less than 3 * capacity + 2 * levels, with about log2(n / capacity) levels
+ * for n values, so n adds only 2 values per doubling to a size that is
+ * otherwise fixed (about 600 values at the default). Two sketches merge by
+ * merging their levels. The rank
+ * error shrinks as 1 / capacity (below 1% of n at the default) and is zero
+ * while n <= capacity.
+ */
+class QuantileSketch {
+ public:
+  explicit QuantileSketch(unsigned int capacity = QUANTILE_SKETCH_CAPACITY);
+  QuantileSketch(const QuantileSketch &sketch);
+  QuantileSketch &operator=(const QuantileSketch &sketch);
+  ~QuantileSketch();
+  void add(double value);
+  void merge(const QuantileSketch &sketch);
+  unsigned long getCount() const;
+  // values retained over all levels
+  unsigned long getSize() const;
+  // smallest retained value with at least probability * count values at or below it (NaN when empty)
+  double getQuantile(double probability) const;
+ private:
+  unsigned int capacity;
+  unsigned long count;
+  std::vector<std::vector<double> > levels;
+  std::vector<bool> keepOdd;  // per level, which half moves up next
+  std::vector<unsigned int> levelCapacities;
+  unsigned long size;   // values on all levels ...
+  unsigned long limit;  // ... and the sum of levelCapacities
+  void addLevel();
+  void compact();
+  void compactLevel(unsigned int level);
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_STATISTICS_QUANTILESKETCH_H_ */
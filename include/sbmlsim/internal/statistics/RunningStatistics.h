@@ -0,0 +1,32 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_STATISTICS_RUNNINGSTATISTICS_H_
+#define INCLUDE_SBMLSIM_INTERNAL_STATISTICS_RUNNINGSTATISTICS_H_
+
+/*
+ * Count, mean, variance, minimum and maximum of a stream of values in O(1)
+ * memory: Welford's update per value, and Chan et al.'s pairwise formula to
+ * merge two partial results (e.g. one per thread).
+ */
+class RunningStatistics {
+ public:
+  RunningStatistics();
+  RunningStatistics(const RunningStatistics &statistics);
+  RunningStatistics &operator=(const RunningStatistics &statistics);
+  ~RunningStatistics();
+  void add(double value);
+  void merge(const RunningStatistics &statistics);
+  unsigned long getCount() const;
+  double getMean() const;
+  // sample variance (0 for fewer than two values)
+  double getVariance() const;
+  double getStandardDeviation() const;
+  double getMin() const;
+  double getMax() const;
+ private:
+  unsigned long count;
+  double mean;
+  double m2;  // sum of squared deviations from the mean
+  double min;
+  double max;
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_STATISTICS_RUNNINGSTATISTICS_H_ */
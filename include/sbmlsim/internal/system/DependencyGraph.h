@@ -0,0 +1,29 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_SYSTEM_DEPENDENCYGRAPH_H_
+#define INCLUDE_SBMLSIM_INTERNAL_SYSTEM_DEPENDENCYGRAPH_H_
+
+#include <vector>
+
+/*
+ * Directed graph over nodes 0..numNodes-1. An edge from -> to means `to`
+ * depends on `from` (e.g. a rule reads the variable another rule assigns).
+ */
+class DependencyGraph {
+ public:
+  explicit DependencyGraph(unsigned int numNodes);
+  DependencyGraph(const DependencyGraph &graph);
+  ~DependencyGraph();
+  void addEdge(unsigned int from, unsigned int to);
+  unsigned int getNumNodes() const;
+  const std::vector<unsigned int> &getSuccessors(unsigned int node) const;
+  const std::vector<unsigned int> &getPredecessors(unsigned int node) const;
+  // marks `node` and every node it transitively depends on
+  void collectDependencies(unsigned int node, std::vector<bool> &collected) const;
+  // stores a topological order (independent nodes keep their index order) in `order`;
+  // returns false if the graph has a cycle, in which case `order` holds only the sortable nodes
+  bool sortTopologically(std::vector<unsigned int> &order) const;
+ private:
+  std::vector<std::vector<unsigned int> > successors;
+  std::vector<std::vector<unsigned int> > predecessors;
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_SYSTEM_DEPENDENCYGRAPH_H_ */
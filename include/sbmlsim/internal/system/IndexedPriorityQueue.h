@@ -0,0 +1,32 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_SYSTEM_INDEXEDPRIORITYQUEUE_H_
+#define INCLUDE_SBMLSIM_INTERNAL_SYSTEM_INDEXEDPRIORITYQUEUE_H_
+
+#include <vector>
+
+/*
+ * Binary min-heap over the keys of items 0..size-1 that also tracks the heap
+ * position of every item, so the key of any item can be changed in
+ * O(log size) (e.g. the putative firing times of the next reaction method).
+ */
+class IndexedPriorityQueue {
+ public:
+  explicit IndexedPriorityQueue(unsigned int size);
+  IndexedPriorityQueue(const IndexedPriorityQueue &queue);
+  ~IndexedPriorityQueue();
+  // sets every key at once in O(size)
+  void build(const std::vector<double> &keys);
+  void update(unsigned int item, double key);
+  unsigned int getTop() const;
+  double getTopKey() const;
+  double getKey(unsigned int item) const;
+  unsigned int getSize() const;
+ private:
+  std::vector<double> keys;
+  std::vector<unsigned int> heap;       // items in heap order
+  std::vector<unsigned int> positions;  // heap position of each item
+  void siftUp(unsigned int position);
+  void siftDown(unsigned int position);
+  void swap(unsigned int position1, unsigned int position2);
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_SYSTEM_INDEXEDPRIORITYQUEUE_H_ */
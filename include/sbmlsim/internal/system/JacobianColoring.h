@@ -0,0 +1,37 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_SYSTEM_JACOBIANCOLORING_H_
+#define INCLUDE_SBMLSIM_INTERNAL_SYSTEM_JACOBIANCOLORING_H_
+
+#include <vector>
+
+/*
+ * Sparsity pattern of a Jacobian and a column coloring for compressed
+ * seeding: columns of the same color never share a row, so seeding all of
+ * them at once yields each of their entries in a single directional
+ * derivative. Nonzeros are collected with add(); color() compresses the
+ * pattern (CSC) and colors the columns greedily.
+ */
+class JacobianColoring {
+ public:
+  JacobianColoring(unsigned int numRows, unsigned int numColumns);
+  JacobianColoring(const JacobianColoring &coloring);
+  ~JacobianColoring();
+  void add(unsigned int row, unsigned int column);
+  void color();
+  unsigned int getNumRows() const;
+  unsigned int getNumColumns() const;
+  unsigned int getNumColors() const;
+  const std::vector<unsigned int> &getColors() const;
+  // CSC
+  const std::vector<unsigned int> &getColumnPointers() const;
+  const std::vector<unsigned int> &getRowIndices() const;
+ private:
+  unsigned int numRows;
+  unsigned int numColumns;
+  unsigned int numColors;
+  std::vector<std::vector<unsigned int> > columns;
+  std::vector<unsigned int> colors;
+  std::vector<unsigned int> columnPointers;
+  std::vector<unsigned int> rowIndices;
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_SYSTEM_JACOBIANCOLORING_H_ */
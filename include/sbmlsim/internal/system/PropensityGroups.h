@@ -0,0 +1,75 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_SYSTEM_PROPENSITYGROUPS_H_
+#define INCLUDE_SBMLSIM_INTERNAL_SYSTEM_PROPENSITYGROUPS_H_
+
+#include <cmath>
+#include <vector>
+
+/*
+ * Reaction propensities grouped by binary exponent for composition-rejection
+ * selection: group e holds the reactions with propensity in [2^(e-1), 2^e).
+ * A group is chosen by linear search over the group sums (their number only
+ * depends on the spread of the propensities), then a member by rejection
+ * sampling against 2^e, which accepts with probability at least 1/2. Moving a
+ * reaction between groups is O(1), so selection cost does not grow with the
+ * number of reactions.
+ */
+class PropensityGroups {
+ public:
+  explicit PropensityGroups(unsigned int numReactions);
+  PropensityGroups(const PropensityGroups &groups);
+  ~PropensityGroups();
+  void update(unsigned int reaction, double propensity);
+  // sum of all propensities
+  double getTotal() const;
+  double getPropensity(unsigned int reaction) const;
+  // reaction with probability propensity / total, drawing uniforms on (0, 1) from `uniform`
+  template<class Uniform>
+  unsigned int select(Uniform &uniform) const;
+ private:
+  // exponents of normal doubles range from -1021 to 1024
+  static const int MIN_EXPONENT = -1022;
+  static const int NUM_EXPONENTS = 2048;
+  static const unsigned int NONE = static_cast<unsigned int>(-1);
+  struct Group {
+    double sum;
+    std::vector<unsigned int> reactions;
+  };
+  std::vector<double> propensities;
+  std::vector<unsigned int> groupOf;    // group per reaction, NONE while its propensity is 0
+  std::vector<unsigned int> positions;  // position of each reaction in its group
+  std::vector<Group> groups;
+  unsigned int minGroup;  // range holding every non-empty group
+  unsigned int maxGroup;
+  unsigned int findGroup(double propensity) const;
+  void insert(unsigned int reaction, unsigned int group);
+  void remove(unsigned int reaction);
+};
+
+template<class Uniform>
+unsigned int PropensityGroups::select(Uniform &uniform) const {
+  // composition: largest groups first
+  double r = uniform() * getTotal();
+  unsigned int group = NONE;
+  for (auto g = this->maxGroup + 1; g > this->minGroup; g--) {
+    if (this->groups[g - 1].reactions.empty()) {
+      continue;
+    }
+    group = g - 1;
+    if (r < this->groups[group].sum) {
+      break;
+    }
+    r -= this->groups[group].sum;
+  }
+
+  // rejection within the group
+  auto &reactions = this->groups[group].reactions;
+  double bound = std::ldexp(1.0, static_cast<int>(group) + MIN_EXPONENT);
+  while (true) {
+    auto k = static_cast<unsigned int>(uniform() * reactions.size());
+    if (k < reactions.size() && uniform() * bound < this->propensities[reactions[k]]) {
+      return reactions[k];
+    }
+  }
+}
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_SYSTEM_PROPENSITYGROUPS_H_ */
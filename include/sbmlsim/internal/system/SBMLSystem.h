@@ -2,9 +2,18 @@
 #define INCLUDE_SBMLSIM_INTERNAL_SYSTEM_SBMLSYSTEM_H_
 
 #include <sbml/SBMLTypes.h>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <boost/numeric/ublas/vector.hpp>
+#include "sbmlsim/internal/bytecode/Bytecode.h"
+#include "sbmlsim/internal/bytecode/Dual.h"
+#include "sbmlsim/internal/system/DependencyGraph.h"
+#include "sbmlsim/internal/system/SBMLSystemBatch.h"
+#include "sbmlsim/internal/system/SBMLSystemDualJacobi.h"
+#include "sbmlsim/internal/system/SBMLSystemJacobi.h"
+#include "sbmlsim/internal/system/StoichiometryMatrix.h"
 #include "sbmlsim/internal/wrapper/ModelWrapper.h"
 #include "sbmlsim/config/OutputField.h"
 #include "sbmlsim/internal/observer/ObserveTarget.h"
@@ -19,25 +28,127 @@ class SBMLSystem {
   SBMLSystem(const SBMLSystem &system);
   ~SBMLSystem();
   void operator()(const state &x, state &dxdt, double t);
+  // same RHS on raw buffers (e.g. for C integrators)
+  void operator()(const double *x, double *dxdt, double t);
   void handleReaction(const state &x, state &dxdt, double t);
-  void handleEvent(state &x, double t);
+  void handleReaction(const double *x, double *dxdt, double t);
+  // executes the events whose trigger became true since the last check, all triggers being checked and all
+  // assignments evaluated before any of them executes, then the events their assignments trigger in turn;
+  // returns whether an event fired
+  bool handleEvent(state &x, double t);
+  // event triggers as continuous root functions: roots[i] > 0 exactly when the trigger of event i holds
+  unsigned int getNumEvents() const;
+  void evaluateEventRoots(state &x, double t, std::vector<double> &roots);
+  // the last check as of the given roots, e.g. from the start of a step in which handleEvent() is due
+  void setEventTriggerStates(const std::vector<double> &roots);
+  // reactions as discrete jumps (stochastic simulation): propensities are the kinetic law values
+  unsigned int getNumReactions() const;
+  bool hasRateRules() const;
+  void evaluatePropensities(const state &x, double t, std::vector<double> &propensities);
+  // only the given reactions (the others keep their values)
+  void evaluatePropensities(const state &x, double t, const std::vector<unsigned int> &reactions,
+                            std::vector<double> &propensities);
+  // edge j -> i: the propensity of reaction i changes when reaction j fires
+  const DependencyGraph &getReactionDependencyGraph() const;
+  void fireReaction(unsigned int reaction, state &x, double t, double count = 1.0);
+  bool hasVariableStoichiometry(unsigned int reaction) const;
+  const StoichiometryMatrix &getStoichiometryMatrix() const;
+  // constant reactant coefficients (the molecularity of each reaction)
+  const StoichiometryMatrix &getReactantMatrix() const;
   void handleInitialAssignment(state &x, double t);
   void handleAlgebraicRule(state &x, double t);
   void handleAssignmentRule(state &x, double t);
   state getInitialState();
-  unsigned int getStateIndexForVariable(const std::string &variableId);
+  unsigned int getStateIndexForVariable(const std::string &variableId) const;
+  bool hasStateVariable(const std::string &variableId) const;
+  double getParameterValue(unsigned int parameterIndex) const;
+  const std::vector<double> &getParameterValues() const;
+  // values that can be set before a run: the parameter block (including reaction-local parameters as
+  // "reactionId.parameterId"), then the initial state (species amounts and rate rule targets)
+  unsigned int getSlot(const std::string &variableId) const;
+  void setSlotValue(unsigned int slot, double value);
+  SBMLSystemJacobi createJacobi();
+  // jv = df/dx * dx + df/dp * dp + df/dt * dt by forward-mode AD (dp may be NULL for no parameter tangent)
+  void directionalDerivative(const state &x, const state &dx, const double *dp, double t, double dt, state &jv);
+  SBMLSystemDualJacobi createDualJacobi();
+  // the RHS for numLanes value sets, each to be set with SBMLSystemBatch::setLane(); not for systems with events
+  SBMLSystemBatch createBatch(unsigned int numLanes) const;
   std::vector<ObserveTarget> createOutputTargetsFromOutputFields(const std::vector<OutputField> &outputFields);
  private:
-  ModelWrapper *model;
+  using Assignment = SymbolAssignment;
+  // everything fixed once the model is compiled
+  struct CompiledModel {
+    std::unordered_map<std::string, unsigned int> stateIndexMap;
+    std::unordered_map<std::string, unsigned int> parameterIndexMap;
+    // compiled expressions (ids into bytecode)
+    std::vector<unsigned int> reactionExpressions;
+    std::vector<VariableStoichiometry> variableStoichiometries;  // by reaction
+    std::vector<unsigned int> variableStoichiometryPointers;  // entries of reaction j: [pointers[j], pointers[j + 1])
+    std::vector<const ASTNode *> variableStoichiometryMaths;
+    std::vector<unsigned int> rateRuleExpressions;
+    std::vector<SymbolBinding> rateRuleTargets;
+    // assignment rules in dependency order; initial assignments also include the assignment rules
+    std::vector<Assignment> assignmentRules;
+    std::unordered_map<unsigned int, unsigned int> assignmentRuleForParameter;
+    std::vector<Assignment> rhsAssignmentRuleSequence;  // required by the RHS and depending on state or time
+    std::vector<Assignment> initialAssignmentSequence;
+    std::vector<unsigned int> eventTriggerExpressions;
+    std::vector<unsigned int> eventRootExpressions;
+    std::vector<std::vector<unsigned int> > eventAssignmentExpressions;
+  };
+  /*
+   * Shared by copies of a system and only read after construction, like the
+   * model: a copy is the state of one run (values, workspace, event latches,
+   * observed rules), so copies can run concurrently.
+   */
+  const ModelWrapper *model;
+  std::shared_ptr<CompiledModel> compiled;
+  std::shared_ptr<Bytecode> bytecode;
+  // dxdt = N * v (+ stoichiometryMath contributions)
+  std::shared_ptr<StoichiometryMatrix> stoichiometryMatrix;
+  std::shared_ptr<StoichiometryMatrix> reactantMatrix;
+  std::shared_ptr<DependencyGraph> assignmentRuleGraph;
+  std::shared_ptr<DependencyGraph> reactionDependencyGraph;
+  // integrated state: species and rate rule targets
   state initialState;
-  std::unordered_map<std::string, unsigned int> stateIndexMap;
-  void handleRateRule(const state &x, state &dxdt, double t);
-  double evaluateASTNode(const ASTNode *node, const state &x, double t);
-  double evaluateNameNode(const ASTNode *node, const state &x, double t);
-  double evaluateFunctionNode(const ASTNode *node, const state &x, double t);
-  double evaluateFactorialNode(const ASTNode *node, const state &x, double t);
-  double evaluatePiecewiseNode(const ASTNode *node, const state &x, double t);
-  bool evaluateConditionalNode(const ASTNode *node, const state &x, double t);
+  // parameter block: all other global parameters and compartments, and species defined by assignment rules
+  std::vector<double> parameters;
+  std::vector<double> stack;
+  std::vector<double> reactionRates;
+  std::vector<double> stoichiometryChanges;  // one per variable stoichiometry entry (fireReaction())
+  // tangents for directionalDerivative()
+  std::vector<Dual> dualStack;
+  std::vector<double> parameterTangents;
+  std::vector<double> reactionRateTangents;
+  std::vector<bool> requiredAssignmentRules;  // by the RHS, events or observed outputs
+  std::vector<Assignment> assignmentRuleSequence;  // required rules, evaluated at output points
+  // whether each trigger held at the last check
+  std::vector<bool> eventTriggerStates;
+  std::vector<bool> pendingEvents;  // triggered at this check
+  std::vector<std::vector<double> > eventAssignmentValues;  // by event, from before the pending events execute
+  void handleRhsAssignmentRule(const double *x, double t);
+  void handleRateRule(const double *x, double *dxdt, double t);
+  double evaluateExpression(unsigned int expressionId, const state &x, double t);
+  double evaluateExpression(unsigned int expressionId, const double *x, double t);
+  Dual evaluateDual(unsigned int expressionId, const state &x, const state &dx, double t, double dt);
+  void setVariableValue(state &x, const std::string &variableId, double value);
+  void executeEvents(state &x, double t);
+  void compileModel();
+  std::unordered_map<std::string, const SpeciesWrapper *> createSpeciesMap();
+  SymbolBinding createBinding(const std::string &name,
+                              const std::unordered_map<std::string, const SpeciesWrapper *> &speciesMap);
+  std::vector<SymbolBinding> bindSymbols(Bytecode &bytecode);
+  DependencyGraph createDependencyGraph(const std::vector<Assignment> &assignments);
+  void sortAssignments(std::vector<Assignment> &assignments, const std::vector<std::string> &variables);
+  void prepareAssignmentRules();
+  DependencyGraph createReactionDependencyGraph();
+  void requireAssignmentRules(unsigned int expressionId, std::vector<bool> &required);
+  void updateAssignmentRuleSequence();
+  double toAmount(const state &x, const SymbolBinding &target, double value);
+  double toAmount(const double *x, const SymbolBinding &target, double value);
+  Dual toAmount(const state &x, const state &dx, const SymbolBinding &target, const Dual &value);
+  void assign(state &x, const SymbolBinding &target, double value);
+  void buildStoichiometryMatrix();
   void prepareInitialState();
 };
 
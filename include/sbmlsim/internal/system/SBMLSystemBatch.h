@@ -0,0 +1,69 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_SYSTEM_SBMLSYSTEMBATCH_H_
+#define INCLUDE_SBMLSIM_INTERNAL_SYSTEM_SBMLSYSTEMBATCH_H_
+
+#include <memory>
+#include <vector>
+#include <boost/numeric/ublas/vector.hpp>
+#include "sbmlsim/internal/bytecode/Bytecode.h"
+#include "sbmlsim/internal/system/StoichiometryMatrix.h"
+
+using namespace boost::numeric;
+
+class SBMLSystem;
+
+/*
+ * The RHS of an SBMLSystem for numLanes value sets at once (see
+ * SBMLSystem::createBatch()), e.g. one model under different parameters.
+ * States, parameter blocks and workspace are structure-of-arrays: value i
+ * of lane l is at [i * numLanes + l], and every expression is evaluated for
+ * all lanes by the BatchInterpreter. The lanes share the time, so they are
+ * meant for fixed-step integration in lockstep (integrate_batch()); events
+ * are not handled.
+ */
+class SBMLSystemBatch {
+ public:
+  using state = ublas::vector<double>;
+ public:
+  SBMLSystemBatch(unsigned int numLanes, unsigned int numStates, unsigned int numParameters,
+                  const std::shared_ptr<Bytecode> &bytecode,
+                  const std::shared_ptr<StoichiometryMatrix> &stoichiometryMatrix,
+                  const std::vector<unsigned int> &reactionExpressions,
+                  const std::vector<VariableStoichiometry> &variableStoichiometries,
+                  const std::vector<unsigned int> &rateRuleExpressions,
+                  const std::vector<SymbolBinding> &rateRuleTargets,
+                  const std::vector<SymbolAssignment> &rhsAssignmentRules,
+                  const std::vector<SymbolAssignment> &assignmentRules);
+  SBMLSystemBatch(const SBMLSystemBatch &batch);
+  ~SBMLSystemBatch();
+  void operator()(const state &x, state &dxdt, double t);
+  // the observed assignment rules of the system, at output points
+  void handleAssignmentRule(state &x, double t);
+  unsigned int getNumLanes() const;
+  // a batch state of zeros
+  state createState() const;
+  // lane takes the parameter block of `system` and the state x
+  void setLane(unsigned int lane, const SBMLSystem &system, const state &x, state &batchState);
+  double getParameterValue(unsigned int lane, unsigned int parameterIndex) const;
+ private:
+  unsigned int numLanes;
+  unsigned int numStates;
+  std::shared_ptr<Bytecode> bytecode;
+  std::shared_ptr<StoichiometryMatrix> stoichiometryMatrix;
+  std::vector<unsigned int> reactionExpressions;
+  std::vector<VariableStoichiometry> variableStoichiometries;
+  std::vector<unsigned int> rateRuleExpressions;
+  std::vector<SymbolBinding> rateRuleTargets;
+  std::vector<SymbolAssignment> rhsAssignmentRules;
+  std::vector<SymbolAssignment> assignmentRules;
+  std::vector<double> parameters;
+  std::vector<double> stack;
+  std::vector<double> reactionRates;
+  std::vector<double> values;  // one expression, all lanes
+  // into values
+  void evaluate(unsigned int expressionId, const double *x, double t);
+  // values of species read as concentrations to amounts
+  void toAmount(const double *x, const SymbolBinding &target);
+  void store(double *destination);
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_SYSTEM_SBMLSYSTEMBATCH_H_ */
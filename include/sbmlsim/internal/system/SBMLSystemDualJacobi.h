@@ -0,0 +1,39 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_SYSTEM_SBMLSYSTEMDUALJACOBI_H_
+#define INCLUDE_SBMLSIM_INTERNAL_SYSTEM_SBMLSYSTEMDUALJACOBI_H_
+
+#include <vector>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include "sbmlsim/internal/system/JacobianColoring.h"
+
+using namespace boost::numeric;
+
+class SBMLSystem;
+
+/*
+ * Jacobian of an SBMLSystem by forward-mode automatic differentiation (see
+ * SBMLSystem::createDualJacobi()). Each call runs one directional derivative
+ * of the RHS per color of the sparsity pattern, seeding every column of that
+ * color at once, plus one along time for dfdt when the RHS depends on time.
+ * Unlike SBMLSystemJacobi nothing is differentiated symbolically.
+ */
+class SBMLSystemDualJacobi {
+ public:
+  using state = ublas::vector<double>;
+  using matrix = ublas::matrix<double>;
+ public:
+  SBMLSystemDualJacobi(SBMLSystem *system, const JacobianColoring &coloring, bool autonomous);
+  SBMLSystemDualJacobi(const SBMLSystemDualJacobi &jacobi);
+  ~SBMLSystemDualJacobi();
+  void operator()(const state &x, matrix &J, const double &t, state &dfdt);
+  const JacobianColoring &getColoring() const;
+ private:
+  SBMLSystem *system;
+  JacobianColoring coloring;
+  bool autonomous;
+  std::vector<std::vector<unsigned int> > columnsByColor;
+  state seed;
+  state product;
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_SYSTEM_SBMLSYSTEMDUALJACOBI_H_ */
@@ -1,17 +1,56 @@
 #ifndef INCLUDE_SBMLSIM_INTERNAL_SYSTEM_SBMLSYSTEMJACOBI_H_
 #define INCLUDE_SBMLSIM_INTERNAL_SYSTEM_SBMLSYSTEMJACOBI_H_
 
+#include <memory>
+#include <vector>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
+#include "sbmlsim/internal/bytecode/Bytecode.h"
 
 using namespace boost::numeric;
 
+class SBMLSystem;
+
+/*
+ * One contribution to the Jacobian: J(row, column) += coefficient * partial,
+ * where partial is the value of partialExpressions[partial]. For dfdt the
+ * column is unused.
+ */
+struct JacobianEntry {
+  unsigned int row;
+  unsigned int column;
+  double coefficient;
+  unsigned int partial;
+};
+
+/*
+ * Sparse analytic Jacobian of an SBMLSystem (see SBMLSystem::createJacobi()).
+ * Partial derivatives are compiled to bytecode and evaluated once per call;
+ * entries scatter them into J and dfdt.
+ */
 class SBMLSystemJacobi {
  public:
   using state = ublas::vector<double>;
   using matrix = ublas::matrix<double>;
  public:
+  SBMLSystemJacobi(const SBMLSystem *system, const std::shared_ptr<Bytecode> &bytecode,
+                   const std::vector<unsigned int> &partialExpressions, const std::vector<JacobianEntry> &entries,
+                   const std::vector<JacobianEntry> &timeEntries);
+  SBMLSystemJacobi(const SBMLSystemJacobi &jacobi);
+  ~SBMLSystemJacobi();
   void operator()(const state &x, matrix &J, const double &t, state &dfdt);
+  void evaluatePartials(const state &x, double t);
+  const std::vector<double> &getPartialValues() const;
+  const std::vector<JacobianEntry> &getEntries() const;
+  const std::vector<JacobianEntry> &getTimeEntries() const;
+ private:
+  const SBMLSystem *system;  // parameter block
+  std::shared_ptr<Bytecode> bytecode;
+  std::vector<unsigned int> partialExpressions;
+  std::vector<double> partialValues;
+  std::vector<double> stack;
+  std::vector<JacobianEntry> entries;
+  std::vector<JacobianEntry> timeEntries;
 };
 
 #endif /* INCLUDE_SBMLSIM_INTERNAL_SYSTEM_SBMLSYSTEMJACOBI_H_ */
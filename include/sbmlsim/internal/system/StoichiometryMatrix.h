@@ -0,0 +1,59 @@
+#ifndef INCLUDE_SBMLSIM_INTERNAL_SYSTEM_STOICHIOMETRYMATRIX_H_
+#define INCLUDE_SBMLSIM_INTERNAL_SYSTEM_STOICHIOMETRYMATRIX_H_
+
+#include <vector>
+
+/*
+ * Stoichiometry given by math (stoichiometryMath). Contributes
+ * sign * rate[reaction] * value(expressionId) to dxdt[row].
+ */
+struct VariableStoichiometry {
+  unsigned int reaction;
+  unsigned int row;
+  double sign;
+  unsigned int expressionId;
+};
+
+/*
+ * Sparse matrix N of constant stoichiometric coefficients (rows: state
+ * variables, columns: reactions). Entries are collected with add() and
+ * compressed once into CSR (for dxdt = N * v) and CSC (per-reaction access).
+ */
+class StoichiometryMatrix {
+ public:
+  StoichiometryMatrix(unsigned int numRows, unsigned int numColumns);
+  StoichiometryMatrix(const StoichiometryMatrix &matrix);
+  ~StoichiometryMatrix();
+  void add(unsigned int row, unsigned int column, double coefficient);
+  void compress();
+  // y = N * v
+  void multiply(const double *v, double *y) const;
+  unsigned int getNumRows() const;
+  unsigned int getNumColumns() const;
+  unsigned int getNumNonZeros() const;
+  // CSR
+  const std::vector<unsigned int> &getRowPointers() const;
+  const std::vector<unsigned int> &getColumnIndices() const;
+  const std::vector<double> &getRowValues() const;
+  // CSC
+  const std::vector<unsigned int> &getColumnPointers() const;
+  const std::vector<unsigned int> &getRowIndices() const;
+  const std::vector<double> &getColumnValues() const;
+ private:
+  struct Entry {
+    unsigned int row;
+    unsigned int column;
+    double coefficient;
+  };
+  unsigned int numRows;
+  unsigned int numColumns;
+  std::vector<Entry> entries;
+  std::vector<unsigned int> rowPointers;
+  std::vector<unsigned int> columnIndices;
+  std::vector<double> rowValues;
+  std::vector<unsigned int> columnPointers;
+  std::vector<unsigned int> rowIndices;
+  std::vector<double> columnValues;
+};
+
+#endif /* INCLUDE_SBMLSIM_INTERNAL_SYSTEM_STOICHIOMETRYMATRIX_H_ */
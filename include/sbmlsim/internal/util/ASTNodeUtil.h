@@ -3,13 +3,25 @@
 
 #include <sbml/SBMLTypes.h>
 #include <cmath>
+#include <set>
+#include <string>
+#include <unordered_map>
 
 class ASTNodeUtil {
  public:
   static ASTNode *rewriteFunctionDefinition(const ASTNode *node, const ListOfFunctionDefinitions *functionDefinitions);
-  static ASTNode *rewriteLocalParameters(const ASTNode *node, const ListOfParameters *localParameters);
+  // renames local parameters to "scope.id" (never a valid SId, so it cannot clash with a global name)
+  static ASTNode *rewriteLocalParameters(const ASTNode *node, const ListOfParameters *localParameters,
+                                         const std::string &scope);
+  static std::string createScopedId(const std::string &scope, const std::string &id);
   static ASTNode *reduceToBinary(const ASTNode *node);
   static bool isEqual(const ASTNode *ast1, const ASTNode *ast2);
+  // replaces names with their definitions, recursively (definitions must not be cyclic)
+  static ASTNode *expandNames(const ASTNode *node, const std::unordered_map<std::string, const ASTNode *> &definitions);
+  static ASTNode *rewriteTimeToName(const ASTNode *node, const std::string &name);
+  static void collectNames(const ASTNode *node, std::set<std::string> &names);
+  // continuous function that is positive exactly where `condition` holds (lhs - rhs for inequalities)
+  static ASTNode *createRootFunction(const ASTNode *condition);
  private:
   ASTNodeUtil() {}
   ~ASTNodeUtil() {}
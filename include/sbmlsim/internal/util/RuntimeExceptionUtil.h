@@ -9,6 +9,9 @@ class RuntimeExceptionUtil {
   static void throwUnknownNodeNameException(const std::string &nodeName);
   static void throwInvalidFlowException();
   static void throwArithmeticException();
+  static void throwCyclicDependencyException(const std::string &variableId);
+  static void throwIntegrationException(const std::string &message);
+  static void throwInvalidArgumentException(const std::string &message);
   private:
   static void throwRuntimeException(const std::string &message);
 };
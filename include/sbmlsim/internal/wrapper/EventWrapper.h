@@ -11,13 +11,13 @@ class EventWrapper {
   EventWrapper(const EventWrapper &event);
   ~EventWrapper();
   const ASTNode *getTrigger() const;
+  // the trigger's value just before the start time (true: a trigger holding at the start time does not fire)
+  bool getTriggerInitialValue() const;
   const std::vector<EventAssignmentWrapper> &getEventAssignments() const;
-  void setTriggerState(bool triggerState);
-  bool getTriggerState() const;
  private:
   ASTNode *trigger;
+  bool triggerInitialValue;
   std::vector<EventAssignmentWrapper> eventAssignments;
-  bool triggerState;
 };
 
 #endif /* INCLUDE_SBMLSIM_INTERNAL_WRAPPER_EVENTWRAPPER_H_ */
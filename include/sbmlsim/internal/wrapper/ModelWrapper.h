@@ -13,28 +13,29 @@
 #include "sbmlsim/internal/wrapper/AssignmentRuleWrapper.h"
 #include "sbmlsim/internal/wrapper/RateRuleWrapper.h"
 
+// immutable once built, so one instance can be read by any number of threads
 class ModelWrapper {
  public:
   explicit ModelWrapper(const Model *model);
   ModelWrapper(const ModelWrapper &model);
   ~ModelWrapper();
   const std::vector<SpeciesWrapper> &getSpecieses() const;
-  std::vector<ParameterWrapper *> &getParameters();
+  const std::vector<const ParameterWrapper *> &getParameters() const;
   const std::vector<CompartmentWrapper> &getCompartments() const;
   const std::vector<ReactionWrapper> &getReactions() const;
-  std::vector<EventWrapper *> &getEvents();
-  std::vector<InitialAssignmentWrapper *> &getInitialAssignments();
-  std::vector<AssignmentRuleWrapper *> &getAssignmentRules();
-  std::vector<RateRuleWrapper *> &getRateRules();
+  const std::vector<const EventWrapper *> &getEvents() const;
+  const std::vector<const InitialAssignmentWrapper *> &getInitialAssignments() const;
+  const std::vector<const AssignmentRuleWrapper *> &getAssignmentRules() const;
+  const std::vector<const RateRuleWrapper *> &getRateRules() const;
  private:
   std::vector<SpeciesWrapper> specieses;
-  std::vector<ParameterWrapper *> parameters;
+  std::vector<const ParameterWrapper *> parameters;
   std::vector<CompartmentWrapper> compartments;
   std::vector<ReactionWrapper> reactions;
-  std::vector<EventWrapper *> events;
-  std::vector<InitialAssignmentWrapper *> initialAssignments;
-  std::vector<AssignmentRuleWrapper *> assignmentRules;
-  std::vector<RateRuleWrapper *> rateRules;
+  std::vector<const EventWrapper *> events;
+  std::vector<const InitialAssignmentWrapper *> initialAssignments;
+  std::vector<const AssignmentRuleWrapper *> assignmentRules;
+  std::vector<const RateRuleWrapper *> rateRules;
 };
 
 #endif /* INCLUDE_SBMLSIM_INTERNAL_WRAPPER_MODELWRAPPER_H_ */
@@ -3,6 +3,7 @@
 
 #include <sbml/SBMLTypes.h>
 #include <string>
+#include <utility>
 #include <vector>
 #include "sbmlsim/internal/wrapper/SpeciesReferenceWrapper.h"
 
@@ -14,12 +15,15 @@ class ReactionWrapper {
   const std::string &getId() const;
   const std::vector<SpeciesReferenceWrapper> &getReactants() const;
   const std::vector<SpeciesReferenceWrapper> &getProducts() const;
-  const ASTNode *getMath();
+  const ASTNode *getMath() const;
+  // scoped ids ("reactionId.parameterId", as in getMath()) and values of the kinetic law's local parameters
+  const std::vector<std::pair<std::string, double> > &getLocalParameters() const;
  private:
   std::string id;
   std::vector<SpeciesReferenceWrapper> reactants;
   std::vector<SpeciesReferenceWrapper> products;
   ASTNode *math;
+  std::vector<std::pair<std::string, double> > localParameters;
 };
 
 #endif /* INCLUDE_SBMLSIM_INTERNAL_WRAPPER_REACTIONWRAPPER_H_ */
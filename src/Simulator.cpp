@@ -0,0 +1,298 @@
+#include "sbmlsim/Simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <boost/numeric/odeint.hpp>
+#include "sbmlsim/internal/integrate/IntegrateAuto.h"
+#include "sbmlsim/internal/integrate/IntegrateBatch.h"
+#include "sbmlsim/internal/integrate/IntegrateCompositionRejection.h"
+#include "sbmlsim/internal/integrate/IntegrateConst.h"
+#include "sbmlsim/internal/integrate/IntegrateDirect.h"
+#include "sbmlsim/internal/integrate/IntegrateEnsemble.h"
+#include "sbmlsim/internal/integrate/IntegrateLSODA.h"
+#include "sbmlsim/internal/integrate/IntegrateNextReaction.h"
+#include "sbmlsim/internal/integrate/IntegrateTauLeaping.h"
+#include "sbmlsim/internal/observer/FunctionObserver.h"
+#include "sbmlsim/internal/observer/StdoutCsvObserver.h"
+#include "sbmlsim/internal/parallel/WorkStealingScheduler.h"
+#include "sbmlsim/internal/util/RuntimeExceptionUtil.h"
+
+using namespace boost::numeric;
+using state = SBMLSystem::state;
+
+Simulator::Simulator(const std::string &filepath) {
+  SBMLReader reader;
+  this->document.reset(reader.readSBMLFromFile(filepath));
+  compile();
+}
+
+Simulator::Simulator(const SBMLDocument *document) {
+  // a private copy of the model (setModel() copies), so the caller's document may change or go away
+  this->document = std::make_shared<SBMLDocument>(document->getLevel(), document->getVersion());
+  this->document->setModel(document->getModel());
+  compile();
+}
+
+Simulator::Simulator(const Simulator &simulator)
+    : document(simulator.document), model(simulator.model), system(simulator.system) {
+  // nothing to do
+}
+
+Simulator::~Simulator() {
+  // nothing to do
+}
+
+void Simulator::run(const RunConfiguration &conf) const {
+  run(conf, std::vector<Override>());
+}
+
+void Simulator::run(const RunConfiguration &conf, const Observer &observer) const {
+  run(conf, std::vector<Override>(), observer);
+}
+
+void Simulator::run(const RunConfiguration &conf, const std::vector<Override> &overrides) const {
+  auto system = createSystem(overrides);
+  StdoutCsvObserver observer(system.createOutputTargetsFromOutputFields(conf.getOutputFields()), &system);
+
+  // print header
+  observer.outputHeader();
+
+  integrate(system, conf, observer);
+}
+
+void Simulator::run(const RunConfiguration &conf, const std::vector<Override> &overrides,
+                    const Observer &observer) const {
+  auto system = createSystem(overrides);
+  FunctionObserver functionObserver(system.createOutputTargetsFromOutputFields(conf.getOutputFields()), &system,
+                                    observer);
+  integrate(system, conf, functionObserver);
+}
+
+unsigned int Simulator::getSlot(const std::string &id) const {
+  return this->system->getSlot(id);
+}
+
+unsigned long Simulator::sweep(const RunConfiguration &conf, const std::vector<unsigned int> &slots,
+                               const std::vector<double> &values, unsigned int numThreads,
+                               const SweepObserver &observer) const {
+  if (slots.empty() || values.size() % slots.size() != 0) {
+    RuntimeExceptionUtil::throwInvalidArgumentException("sweep values must come in rows of one value per slot");
+  }
+  auto numRows = values.size() / slots.size();
+
+  WorkStealingScheduler scheduler(numThreads);
+  if (conf.getIntegrator() == IntegratorType::RUNGE_KUTTA_4 && this->system->getNumEvents() == 0) {
+    auto numBatches = (numRows + BATCH_NUM_LANES - 1) / BATCH_NUM_LANES;
+    scheduler.run(numBatches, [&](unsigned int /* worker */, unsigned long batchIndex) {
+      auto firstRow = batchIndex * BATCH_NUM_LANES;
+      auto numLanes = static_cast<unsigned int>(std::min<unsigned long>(BATCH_NUM_LANES, numRows - firstRow));
+      sweepBatch(conf, slots, values, firstRow, numLanes, observer);
+    });
+    return numRows;
+  }
+  scheduler.run(numRows, [&](unsigned int /* worker */, unsigned long row) {
+    auto system = createSystem(createOverrides(slots, values, row));
+    FunctionObserver rowObserver(system.createOutputTargetsFromOutputFields(conf.getOutputFields()), &system,
+                                 [&observer, row](double t, const std::vector<double> &output) {
+                                   observer(row, t, output);
+                                 });
+    integrate(system, conf, rowObserver);
+  });
+  return numRows;
+}
+
+unsigned long Simulator::sweep(const RunConfiguration &conf, const std::vector<unsigned int> &slots,
+                               const std::vector<double> &values, unsigned int numThreads, double *results) const {
+  auto numPoints = getNumOutputPoints(conf);
+  auto numFields = conf.getOutputFields().size();
+  auto start = conf.getStart();
+  auto stepInterval = conf.getStepInterval();
+  return sweep(conf, slots, values, numThreads, [&](unsigned long row, double t, const std::vector<double> &output) {
+    // output points lie on the grid, so the time gives the point
+    auto point = std::llround((t - start) / stepInterval);
+    if (point < 0 || static_cast<unsigned long>(point) >= numPoints) {
+      RuntimeExceptionUtil::throwIntegrationException("output point outside of the result tensor");
+    }
+    std::copy(output.begin(), output.end(), results + (row * numPoints + point) * numFields);
+  });
+}
+
+unsigned long Simulator::ensemble(const RunConfiguration &conf, unsigned long numTrajectories,
+                                 unsigned int numThreads, const EnsembleObserver &observer) const {
+  auto system = createSystem(std::vector<Override>());
+  checkIntegrator(system, conf.getIntegrator());
+  auto targets = system.createOutputTargetsFromOutputFields(conf.getOutputFields());
+  if (numThreads == 0) {
+    numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  // one output buffer per worker
+  std::vector<std::vector<double> > outputs(numThreads, std::vector<double>(targets.size()));
+  auto trajectoryObserver = [&](unsigned int worker, unsigned long trajectory, const SBMLSystem &trajectorySystem,
+                                const SBMLSystem::state &x, double t) {
+    auto &output = outputs[worker];
+    for (unsigned int k = 0; k < targets.size(); k++) {
+      auto index = targets[k].getStateIndex();
+      output[k] = targets[k].isParameter() ? trajectorySystem.getParameterValue(index) : x[index];
+    }
+    observer(trajectory, t, output);
+  };
+  auto statistics = sbmlsim::integrate_ensemble(system, conf.getIntegrator(), conf.getStart(), conf.getDuration(),
+                                                conf.getStepInterval(), numTrajectories, conf.getSeed(), numThreads,
+                                                std::ref(trajectoryObserver));
+  return statistics.numFirings;
+}
+
+unsigned long Simulator::getNumOutputPoints(const RunConfiguration &conf) {
+  // the same test as the integrators' output loops
+  unsigned long numPoints = 0;
+  while (odeint::detail::less_eq_with_sign(conf.getStart() + static_cast<double>(numPoints) * conf.getStepInterval(),
+                                           conf.getDuration(), conf.getStepInterval())) {
+    numPoints++;
+  }
+  return numPoints;
+}
+
+void Simulator::compile() {
+  this->model = std::make_shared<ModelWrapper>(this->document->getModel());
+  this->system = std::make_shared<const SBMLSystem>(this->model.get());
+}
+
+SBMLSystem Simulator::createSystem(const std::vector<Override> &overrides) const {
+  SBMLSystem system(*this->system);
+  for (auto &entry : overrides) {
+    system.setSlotValue(entry.first, entry.second);
+  }
+  return system;
+}
+
+std::vector<Simulator::Override> Simulator::createOverrides(const std::vector<unsigned int> &slots,
+                                                           const std::vector<double> &values, unsigned long row) {
+  std::vector<Override> overrides(slots.size());
+  for (unsigned int k = 0; k < slots.size(); k++) {
+    overrides[k] = std::make_pair(slots[k], values[row * slots.size() + k]);
+  }
+  return overrides;
+}
+
+void Simulator::sweepBatch(const RunConfiguration &conf, const std::vector<unsigned int> &slots,
+                           const std::vector<double> &values, unsigned long firstRow, unsigned int numLanes,
+                           const SweepObserver &observer) const {
+  // the output targets also decide which assignment rules are evaluated at output points
+  auto system = createSystem(std::vector<Override>());
+  auto targets = system.createOutputTargetsFromOutputFields(conf.getOutputFields());
+  auto batch = system.createBatch(numLanes);
+  auto x = batch.createState();
+  for (unsigned int lane = 0; lane < numLanes; lane++) {
+    auto laneSystem = createSystem(createOverrides(slots, values, firstRow + lane));
+    auto laneState = laneSystem.getInitialState();
+    laneSystem.handleInitialAssignment(laneState, conf.getStart());
+    batch.setLane(lane, laneSystem, laneState, x);
+  }
+
+  std::vector<double> output(targets.size());
+  auto batchObserver = [&](const SBMLSystemBatch::state &batchState, double t) {
+    for (unsigned int lane = 0; lane < numLanes; lane++) {
+      for (unsigned int k = 0; k < targets.size(); k++) {
+        auto index = targets[k].getStateIndex();
+        output[k] = targets[k].isParameter() ? batch.getParameterValue(lane, index)
+                                             : batchState[index * numLanes + lane];
+      }
+      observer(firstRow + lane, t, output);
+    }
+  };
+  sbmlsim::integrate_batch(batch, x, conf.getStart(), conf.getDuration(), conf.getStepInterval(),
+                           std::ref(batchObserver));
+}
+
+void Simulator::checkIntegrator(const SBMLSystem &system, IntegratorType integrator) {
+  if (integrator == IntegratorType::GILLESPIE_DIRECT || integrator == IntegratorType::GILLESPIE_NEXT_REACTION
+      || integrator == IntegratorType::GILLESPIE_COMPOSITION_REJECTION || integrator == IntegratorType::TAU_LEAPING) {
+    if (system.hasRateRules()) {
+      RuntimeExceptionUtil::throwIntegrationException("rate rules cannot be simulated stochastically");
+    }
+  }
+}
+
+template<class RunObserver>
+void Simulator::integrate(SBMLSystem &system, const RunConfiguration &conf, RunObserver &observer) {
+  auto initialState = system.getInitialState();
+  auto start = conf.getStart();
+  auto duration = conf.getDuration();
+  auto stepInterval = conf.getStepInterval();
+  // steppers take tolerances two digits tighter than requested
+  auto absoluteTolerance = conf.getAbsoluteTolerance() / 100.0;
+  auto relativeTolerance = conf.getRelativeTolerance() / 100.0;
+  auto integrator = conf.getIntegrator();
+  checkIntegrator(system, integrator);
+  std::mt19937_64 random(conf.getSeed());
+
+  switch (integrator) {
+    case IntegratorType::RUNGE_KUTTA_4: {
+      odeint::runge_kutta4<state> stepper;
+      sbmlsim::integrate_const(stepper, system, initialState, start, duration, stepInterval, std::ref(observer));
+      break;
+    }
+    case IntegratorType::RUNGE_KUTTA_DOPRI5: {
+      // dense output: steps are not cut at output points
+      auto stepper = odeint::make_dense_output<odeint::runge_kutta_dopri5<state> >(absoluteTolerance,
+                                                                                    relativeTolerance);
+      sbmlsim::integrate_const(stepper, system, initialState, start, duration, stepInterval, std::ref(observer));
+      break;
+    }
+    case IntegratorType::RUNGE_KUTTA_FEHLBERG78: {
+      auto stepper = odeint::make_controlled<odeint::runge_kutta_fehlberg78<state> >(absoluteTolerance,
+                                                                                      relativeTolerance);
+      sbmlsim::integrate_const(stepper, system, initialState, start, duration, stepInterval, std::ref(observer));
+      break;
+    }
+    case IntegratorType::ROSENBROCK4:
+      // implicit from the start, with the analytic Jacobian
+      sbmlsim::integrate_auto(system, initialState, start, duration, stepInterval, absoluteTolerance,
+                              relativeTolerance, true, std::ref(observer));
+      break;
+    case IntegratorType::AUTO:
+      // explicit until the problem turns stiff, then with the forward-mode AD Jacobian
+      sbmlsim::integrate_auto(system, initialState, start, duration, stepInterval, absoluteTolerance,
+                              relativeTolerance, false, std::ref(observer));
+      break;
+    case IntegratorType::LSODA: {
+      // tolerances per state variable, scaled like those of the other steppers
+      std::vector<double> rtol(initialState.size(), relativeTolerance);
+      std::vector<double> atol(initialState.size(), absoluteTolerance);
+      for (auto &tolerance : conf.getRelativeTolerances()) {
+        if (system.hasStateVariable(tolerance.first)) {
+          rtol[system.getStateIndexForVariable(tolerance.first)] = tolerance.second / 100.0;
+        }
+      }
+      for (auto &tolerance : conf.getAbsoluteTolerances()) {
+        if (system.hasStateVariable(tolerance.first)) {
+          atol[system.getStateIndexForVariable(tolerance.first)] = tolerance.second / 100.0;
+        }
+      }
+      auto statistics = sbmlsim::integrate_lsoda(system, initialState, start, duration, stepInterval, rtol, atol,
+                                                 std::ref(observer));
+      if (statistics.state <= 0) {
+        RuntimeExceptionUtil::throwIntegrationException(statistics.error);
+      }
+      break;
+    }
+    case IntegratorType::GILLESPIE_DIRECT:
+      sbmlsim::integrate_direct(system, initialState, start, duration, stepInterval, random, std::ref(observer));
+      break;
+    case IntegratorType::GILLESPIE_NEXT_REACTION:
+      sbmlsim::integrate_next_reaction(system, initialState, start, duration, stepInterval, random,
+                                       std::ref(observer));
+      break;
+    case IntegratorType::GILLESPIE_COMPOSITION_REJECTION:
+      sbmlsim::integrate_composition_rejection(system, initialState, start, duration, stepInterval, random,
+                                               std::ref(observer));
+      break;
+    case IntegratorType::TAU_LEAPING:
+      sbmlsim::integrate_tau_leaping(system, initialState, start, duration, stepInterval, TAU_LEAPING_EPSILON,
+                                     random, std::ref(observer));
+      break;
+  }
+}
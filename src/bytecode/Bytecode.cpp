@@ -0,0 +1,136 @@
+#include "sbmlsim/internal/bytecode/Bytecode.h"
+
+Bytecode::Bytecode() : maxStackDepth(0) {
+  // nothing to do
+}
+
+Bytecode::Bytecode(const Bytecode &bytecode)
+    : instructions(bytecode.instructions), entryPoints(bytecode.entryPoints), symbols(bytecode.symbols),
+      symbolIndexMap(bytecode.symbolIndexMap), maxStackDepth(bytecode.maxStackDepth) {
+  // nothing to do
+}
+
+Bytecode::~Bytecode() {
+  this->instructions.clear();
+  this->entryPoints.clear();
+  this->symbols.clear();
+  this->symbolIndexMap.clear();
+}
+
+unsigned int Bytecode::getSize() const {
+  return this->instructions.size();
+}
+
+void Bytecode::emit(OpCode op, unsigned int operand, double value) {
+  Instruction instruction;
+  instruction.op = op;
+  instruction.operand = operand;
+  instruction.value = value;
+  this->instructions.push_back(instruction);
+}
+
+void Bytecode::patchOperand(unsigned int position, unsigned int operand) {
+  this->instructions[position].operand = operand;
+}
+
+unsigned int Bytecode::addSymbol(const std::string &name) {
+  auto it = this->symbolIndexMap.find(name);
+  if (it != this->symbolIndexMap.end()) {
+    return it->second;
+  }
+  unsigned int symbolId = this->symbols.size();
+  this->symbols.push_back(name);
+  this->symbolIndexMap[name] = symbolId;
+  return symbolId;
+}
+
+unsigned int Bytecode::addExpression(unsigned int entryPoint, unsigned int stackDepth) {
+  this->entryPoints.push_back(entryPoint);
+  if (stackDepth > this->maxStackDepth) {
+    this->maxStackDepth = stackDepth;
+  }
+  return this->entryPoints.size() - 1;
+}
+
+void Bytecode::bindSymbols(const std::vector<SymbolBinding> &bindings) {
+  for (auto &instruction : this->instructions) {
+    if (instruction.op != OpCode::LOAD_SYMBOL) {
+      continue;
+    }
+    auto &binding = bindings[instruction.operand];
+    if (binding.concentration) {
+      if (binding.parameter) {
+        instruction.op = binding.compartmentParameter ? OpCode::LOAD_CONCENTRATION_PP : OpCode::LOAD_CONCENTRATION_PX;
+      } else {
+        instruction.op = binding.compartmentParameter ? OpCode::LOAD_CONCENTRATION_XP : OpCode::LOAD_CONCENTRATION_XX;
+      }
+      instruction.operand = binding.index;
+      instruction.compartment = binding.compartmentIndex;
+    } else {
+      instruction.op = binding.parameter ? OpCode::LOAD_PARAMETER : OpCode::LOAD_STATE;
+      instruction.operand = binding.index;
+    }
+  }
+}
+
+const Instruction *Bytecode::getEntryPoint(unsigned int expressionId) const {
+  return &this->instructions[this->entryPoints[expressionId]];
+}
+
+unsigned int Bytecode::getNumExpressions() const {
+  return this->entryPoints.size();
+}
+
+unsigned int Bytecode::getMaxStackDepth() const {
+  return this->maxStackDepth;
+}
+
+const std::string &Bytecode::getSymbol(unsigned int symbolId) const {
+  return this->symbols[symbolId];
+}
+
+unsigned int Bytecode::getNumSymbols() const {
+  return this->symbols.size();
+}
+
+void Bytecode::collectLoads(unsigned int expressionId, std::vector<unsigned int> &stateIndices,
+                            std::vector<unsigned int> &parameterIndices) const {
+  // jumps only go forward, so an expression is the range from its entry point to the first RETURN
+  for (auto pc = getEntryPoint(expressionId); pc->op != OpCode::RETURN; pc++) {
+    switch (pc->op) {
+      case OpCode::LOAD_STATE:
+        stateIndices.push_back(pc->operand);
+        break;
+      case OpCode::LOAD_PARAMETER:
+        parameterIndices.push_back(pc->operand);
+        break;
+      case OpCode::LOAD_CONCENTRATION_XX:
+        stateIndices.push_back(pc->operand);
+        stateIndices.push_back(pc->compartment);
+        break;
+      case OpCode::LOAD_CONCENTRATION_XP:
+        stateIndices.push_back(pc->operand);
+        parameterIndices.push_back(pc->compartment);
+        break;
+      case OpCode::LOAD_CONCENTRATION_PX:
+        parameterIndices.push_back(pc->operand);
+        stateIndices.push_back(pc->compartment);
+        break;
+      case OpCode::LOAD_CONCENTRATION_PP:
+        parameterIndices.push_back(pc->operand);
+        parameterIndices.push_back(pc->compartment);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+bool Bytecode::dependsOnTime(unsigned int expressionId) const {
+  for (auto pc = getEntryPoint(expressionId); pc->op != OpCode::RETURN; pc++) {
+    if (pc->op == OpCode::LOAD_TIME) {
+      return true;
+    }
+  }
+  return false;
+}
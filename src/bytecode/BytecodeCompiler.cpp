@@ -0,0 +1,281 @@
+#include "sbmlsim/internal/bytecode/BytecodeCompiler.h"
+#include <limits>
+#include <vector>
+#include "sbmlsim/internal/util/RuntimeExceptionUtil.h"
+
+unsigned int BytecodeCompiler::compile(const ASTNode *node, Bytecode &bytecode) {
+  unsigned int entryPoint = bytecode.getSize();
+  unsigned int depth = 0;
+  unsigned int maxDepth = 0;
+  compileNode(node, bytecode, depth, maxDepth);
+  emit(bytecode, OpCode::RETURN, 0, depth, maxDepth);
+  return bytecode.addExpression(entryPoint, maxDepth);
+}
+
+void BytecodeCompiler::compileNode(const ASTNode *node, Bytecode &bytecode, unsigned int &depth,
+                                   unsigned int &maxDepth) {
+  // lambdas
+  auto compileChild = [&](unsigned int i) {
+    compileNode(node->getChild(i), bytecode, depth, maxDepth);
+  };
+  auto compileUnary = [&](OpCode op) {
+    compileChild(0);
+    emit(bytecode, op, 0, depth, maxDepth);
+  };
+  auto compileBinary = [&](OpCode op) {
+    compileChild(0);
+    compileChild(1);
+    emit(bytecode, op, -1, depth, maxDepth);
+  };
+  auto compileReciprocal = [&](OpCode op) {
+    emit(bytecode, OpCode::PUSH_CONSTANT, 1, depth, maxDepth, 0, 1.0);
+    compileUnary(op);
+    emit(bytecode, OpCode::DIVIDE, -1, depth, maxDepth);
+  };
+  auto pushConstant = [&](double value) {
+    emit(bytecode, OpCode::PUSH_CONSTANT, 1, depth, maxDepth, 0, value);
+  };
+
+  ASTNodeType_t type = node->getType();
+  switch (type) {
+    // operands
+    case AST_NAME:
+      emit(bytecode, OpCode::LOAD_SYMBOL, 1, depth, maxDepth, bytecode.addSymbol(node->getName()));
+      break;
+    case AST_NAME_TIME:
+      emit(bytecode, OpCode::LOAD_TIME, 1, depth, maxDepth);
+      break;
+    case AST_NAME_AVOGADRO:
+      pushConstant(6.02214179e23);
+      break;
+    case AST_INTEGER:
+      pushConstant(node->getInteger());
+      break;
+    case AST_REAL:
+      pushConstant(node->getReal());
+      break;
+    case AST_RATIONAL:
+    case AST_REAL_E:
+    case AST_CONSTANT_E:
+    case AST_CONSTANT_PI:
+      pushConstant(node->getValue());
+      break;
+    case AST_CONSTANT_TRUE:
+      pushConstant(1.0);
+      break;
+    case AST_CONSTANT_FALSE:
+      pushConstant(0.0);
+      break;
+    // arithmetic
+    case AST_PLUS:
+      compileFoldedNode(node, OpCode::ADD, 0.0, bytecode, depth, maxDepth);
+      break;
+    case AST_TIMES:
+      compileFoldedNode(node, OpCode::MULTIPLY, 1.0, bytecode, depth, maxDepth);
+      break;
+    case AST_MINUS:
+      if (node->getNumChildren() == 1) {
+        compileUnary(OpCode::NEGATE);
+      } else {
+        compileBinary(OpCode::SUBTRACT);
+      }
+      break;
+    case AST_DIVIDE:
+      compileBinary(OpCode::DIVIDE);
+      break;
+    case AST_POWER:
+    case AST_FUNCTION_POWER:
+      compileBinary(OpCode::POWER);
+      break;
+    case AST_FUNCTION_ROOT:
+      if (node->getNumChildren() == 1) {
+        // sqrt(x) = x^0.5
+        compileChild(0);
+        pushConstant(0.5);
+      } else {
+        // root(n, x) = x^(1/n)
+        compileChild(1);
+        pushConstant(1.0);
+        compileChild(0);
+        emit(bytecode, OpCode::DIVIDE, -1, depth, maxDepth);
+      }
+      emit(bytecode, OpCode::POWER, -1, depth, maxDepth);
+      break;
+    // functions
+    case AST_FUNCTION_EXP:
+      compileUnary(OpCode::EXP);
+      break;
+    case AST_FUNCTION_LN:
+      compileUnary(OpCode::LN);
+      break;
+    case AST_FUNCTION_LOG:
+      if (node->getNumChildren() == 1) {
+        // log(x) = log(10, x)
+        pushConstant(10.0);
+        compileChild(0);
+        emit(bytecode, OpCode::LOG, -1, depth, maxDepth);
+      } else {
+        compileBinary(OpCode::LOG);
+      }
+      break;
+    case AST_FUNCTION_ABS:
+      compileUnary(OpCode::ABS);
+      break;
+    case AST_FUNCTION_CEILING:
+      compileUnary(OpCode::CEILING);
+      break;
+    case AST_FUNCTION_FLOOR:
+      compileUnary(OpCode::FLOOR);
+      break;
+    case AST_FUNCTION_FACTORIAL:
+      compileUnary(OpCode::FACTORIAL);
+      break;
+    case AST_FUNCTION_SIN:
+      compileUnary(OpCode::SIN);
+      break;
+    case AST_FUNCTION_COS:
+      compileUnary(OpCode::COS);
+      break;
+    case AST_FUNCTION_TAN:
+      compileUnary(OpCode::TAN);
+      break;
+    case AST_FUNCTION_SEC:
+      compileReciprocal(OpCode::COS);
+      break;
+    case AST_FUNCTION_CSC:
+      compileReciprocal(OpCode::SIN);
+      break;
+    case AST_FUNCTION_COT:
+      compileReciprocal(OpCode::TAN);
+      break;
+    case AST_FUNCTION_SINH:
+      compileUnary(OpCode::SINH);
+      break;
+    case AST_FUNCTION_COSH:
+      compileUnary(OpCode::COSH);
+      break;
+    case AST_FUNCTION_TANH:
+      compileUnary(OpCode::TANH);
+      break;
+    case AST_FUNCTION_ARCSIN:
+      compileUnary(OpCode::ARCSIN);
+      break;
+    case AST_FUNCTION_ARCCOS:
+      compileUnary(OpCode::ARCCOS);
+      break;
+    case AST_FUNCTION_ARCTAN:
+      compileUnary(OpCode::ARCTAN);
+      break;
+    case AST_FUNCTION_PIECEWISE:
+      compilePiecewiseNode(node, bytecode, depth, maxDepth);
+      break;
+    // relational
+    case AST_RELATIONAL_LT:
+      compileRelationalNode(node, OpCode::LT, bytecode, depth, maxDepth);
+      break;
+    case AST_RELATIONAL_LEQ:
+      compileRelationalNode(node, OpCode::LEQ, bytecode, depth, maxDepth);
+      break;
+    case AST_RELATIONAL_GT:
+      compileRelationalNode(node, OpCode::GT, bytecode, depth, maxDepth);
+      break;
+    case AST_RELATIONAL_GEQ:
+      compileRelationalNode(node, OpCode::GEQ, bytecode, depth, maxDepth);
+      break;
+    case AST_RELATIONAL_EQ:
+      compileRelationalNode(node, OpCode::EQ, bytecode, depth, maxDepth);
+      break;
+    case AST_RELATIONAL_NEQ:
+      compileBinary(OpCode::NEQ);
+      break;
+    // logical
+    case AST_LOGICAL_AND:
+      compileFoldedNode(node, OpCode::AND, 1.0, bytecode, depth, maxDepth);
+      break;
+    case AST_LOGICAL_OR:
+      compileFoldedNode(node, OpCode::OR, 0.0, bytecode, depth, maxDepth);
+      break;
+    case AST_LOGICAL_XOR:
+      compileFoldedNode(node, OpCode::XOR, 0.0, bytecode, depth, maxDepth);
+      break;
+    case AST_LOGICAL_NOT:
+      compileUnary(OpCode::NOT);
+      break;
+    default:
+      RuntimeExceptionUtil::throwUnknownNodeTypeException(type);
+      break;
+  }
+}
+
+void BytecodeCompiler::compileFoldedNode(const ASTNode *node, OpCode op, double identity, Bytecode &bytecode,
+                                         unsigned int &depth, unsigned int &maxDepth) {
+  // n-ary nodes are folded from the left: (((x y op) z op) ...)
+  auto numChildren = node->getNumChildren();
+  if (numChildren == 0) {
+    emit(bytecode, OpCode::PUSH_CONSTANT, 1, depth, maxDepth, 0, identity);
+    return;
+  }
+  compileNode(node->getChild(0), bytecode, depth, maxDepth);
+  for (unsigned int i = 1; i < numChildren; i++) {
+    compileNode(node->getChild(i), bytecode, depth, maxDepth);
+    emit(bytecode, op, -1, depth, maxDepth);
+  }
+}
+
+void BytecodeCompiler::compileRelationalNode(const ASTNode *node, OpCode op, Bytecode &bytecode,
+                                             unsigned int &depth, unsigned int &maxDepth) {
+  // a < b < c is evaluated as (a < b) && (b < c)
+  auto numChildren = node->getNumChildren();
+  for (unsigned int i = 0; i + 1 < numChildren; i++) {
+    compileNode(node->getChild(i), bytecode, depth, maxDepth);
+    compileNode(node->getChild(i + 1), bytecode, depth, maxDepth);
+    emit(bytecode, op, -1, depth, maxDepth);
+    if (i > 0) {
+      emit(bytecode, OpCode::AND, -1, depth, maxDepth);
+    }
+  }
+}
+
+void BytecodeCompiler::compilePiecewiseNode(const ASTNode *node, Bytecode &bytecode, unsigned int &depth,
+                                            unsigned int &maxDepth) {
+  //
+  //   [cond0] JUMP_IF_FALSE L1 [piece0] JUMP END
+  //   L1: [cond1] JUMP_IF_FALSE L2 [piece1] JUMP END
+  //   L2: [otherwise]
+  //   END:
+  //
+  auto numChildren = node->getNumChildren();
+  auto baseDepth = depth;
+  std::vector<unsigned int> jumpsToEnd;
+
+  for (unsigned int i = 0; i + 1 < numChildren; i += 2) {
+    compileNode(node->getChild(i + 1), bytecode, depth, maxDepth);
+    auto jumpToNext = bytecode.getSize();
+    emit(bytecode, OpCode::JUMP_IF_FALSE, -1, depth, maxDepth);
+    compileNode(node->getChild(i), bytecode, depth, maxDepth);
+    jumpsToEnd.push_back(bytecode.getSize());
+    emit(bytecode, OpCode::JUMP, 0, depth, maxDepth);
+    bytecode.patchOperand(jumpToNext, bytecode.getSize() - jumpToNext);
+    depth = baseDepth;
+  }
+
+  // otherwise node (undefined if absent)
+  if (numChildren % 2 == 1) {
+    compileNode(node->getRightChild(), bytecode, depth, maxDepth);
+  } else {
+    emit(bytecode, OpCode::PUSH_CONSTANT, 1, depth, maxDepth, 0, std::numeric_limits<double>::quiet_NaN());
+  }
+
+  for (auto jump : jumpsToEnd) {
+    bytecode.patchOperand(jump, bytecode.getSize() - jump);
+  }
+}
+
+void BytecodeCompiler::emit(Bytecode &bytecode, OpCode op, int stackEffect, unsigned int &depth,
+                            unsigned int &maxDepth, unsigned int operand, double value) {
+  bytecode.emit(op, operand, value);
+  depth += stackEffect;
+  if (depth > maxDepth) {
+    maxDepth = depth;
+  }
+}
@@ -3,7 +3,8 @@
 RunConfiguration::RunConfiguration(double duration, double stepInterval, std::vector<OutputField> outputFields,
                                    double absoluteTolerance, double relativeTolerance)
     : start(0), duration(duration), stepInterval(stepInterval), outputFields(outputFields),
-      absoluteTolerance(absoluteTolerance), relativeTolerance(relativeTolerance) {
+      absoluteTolerance(absoluteTolerance), relativeTolerance(relativeTolerance),
+      integrator(IntegratorType::RUNGE_KUTTA_DOPRI5), seed(0) {
   // nothing to do
 }
 
@@ -11,7 +12,8 @@ RunConfiguration::RunConfiguration(double start, double duration, double stepInt
                                    std::vector<OutputField> outputFields, double absoluteTolerance,
                                    double relativeTolerance)
     : start(start), duration(duration), stepInterval(stepInterval), outputFields(outputFields),
-      absoluteTolerance(absoluteTolerance), relativeTolerance(relativeTolerance) {
+      absoluteTolerance(absoluteTolerance), relativeTolerance(relativeTolerance),
+      integrator(IntegratorType::RUNGE_KUTTA_DOPRI5), seed(0) {
   // nothing to do
 }
 
@@ -42,3 +44,35 @@ double RunConfiguration::getAbsoluteTolerance() const {
 double RunConfiguration::getRelativeTolerance() const {
   return this->relativeTolerance;
 }
+
+void RunConfiguration::setAbsoluteTolerance(const std::string &variableId, double absoluteTolerance) {
+  this->absoluteTolerances[variableId] = absoluteTolerance;
+}
+
+void RunConfiguration::setRelativeTolerance(const std::string &variableId, double relativeTolerance) {
+  this->relativeTolerances[variableId] = relativeTolerance;
+}
+
+const std::unordered_map<std::string, double> &RunConfiguration::getAbsoluteTolerances() const {
+  return this->absoluteTolerances;
+}
+
+const std::unordered_map<std::string, double> &RunConfiguration::getRelativeTolerances() const {
+  return this->relativeTolerances;
+}
+
+void RunConfiguration::setIntegrator(IntegratorType integrator) {
+  this->integrator = integrator;
+}
+
+IntegratorType RunConfiguration::getIntegrator() const {
+  return this->integrator;
+}
+
+void RunConfiguration::setSeed(unsigned long seed) {
+  this->seed = seed;
+}
+
+unsigned long RunConfiguration::getSeed() const {
+  return this->seed;
+}
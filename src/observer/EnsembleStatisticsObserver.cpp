@@ -0,0 +1,97 @@
+#include "sbmlsim/internal/observer/EnsembleStatisticsObserver.h"
+#include <algorithm>
+#include <thread>
+#include "sbmlsim/internal/util/RuntimeExceptionUtil.h"
+
+#define NO_TRAJECTORY static_cast<unsigned long>(-1)
+
+EnsembleStatisticsObserver::EnsembleStatisticsObserver(const std::vector<ObserveTarget> &targets,
+                                                       unsigned int numWorkers, unsigned int sketchCapacity)
+    : targets(targets), sketchCapacity(sketchCapacity) {
+  if (numWorkers == 0) {
+    numWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  this->workers.resize(numWorkers);
+  for (auto &worker : this->workers) {
+    worker.trajectory = NO_TRAJECTORY;
+    worker.position = 0;
+  }
+}
+
+EnsembleStatisticsObserver::EnsembleStatisticsObserver(const EnsembleStatisticsObserver &observer)
+    : targets(observer.targets), sketchCapacity(observer.sketchCapacity), workers(observer.workers) {
+  // nothing to do
+}
+
+EnsembleStatisticsObserver::~EnsembleStatisticsObserver() {
+  // nothing to do
+}
+
+void EnsembleStatisticsObserver::operator()(unsigned int worker, unsigned long trajectory, const SBMLSystem &system,
+                                            const SBMLSystem::state &x, double t) {
+  if (worker >= this->workers.size()) {
+    RuntimeExceptionUtil::throwIntegrationException("more ensemble workers than accumulators");
+  }
+  // a worker runs its trajectories one after another
+  auto &current = this->workers[worker];
+  if (current.trajectory != trajectory) {
+    current.trajectory = trajectory;
+    current.position = 0;
+  }
+  auto numTargets = this->targets.size();
+  if (current.position == current.times.size()) {
+    current.times.push_back(t);
+    current.accumulators.resize(current.accumulators.size() + numTargets, Accumulator(this->sketchCapacity));
+  }
+  auto accumulator = current.accumulators.begin() + current.position * numTargets;
+  for (auto &target : this->targets) {
+    auto index = target.getStateIndex();
+    double value = target.isParameter() ? system.getParameterValue(index) : x[index];
+    accumulator->statistics.add(value);
+    if (this->sketchCapacity > 0) {
+      accumulator->quantiles.add(value);
+    }
+    accumulator++;
+  }
+  current.position++;
+}
+
+void EnsembleStatisticsObserver::merge() {
+  auto &merged = this->workers[0];
+  for (unsigned int i = 1; i < this->workers.size(); i++) {
+    auto &worker = this->workers[i];
+    if (worker.times.size() > merged.times.size()) {
+      merged.accumulators.resize(worker.accumulators.size(), Accumulator(this->sketchCapacity));
+      merged.times = worker.times;
+    }
+    for (unsigned int k = 0; k < worker.accumulators.size(); k++) {
+      merged.accumulators[k].statistics.merge(worker.accumulators[k].statistics);
+      merged.accumulators[k].quantiles.merge(worker.accumulators[k].quantiles);
+    }
+    // release the memory, not only the elements
+    std::vector<double>().swap(worker.times);
+    std::vector<Accumulator>().swap(worker.accumulators);
+  }
+}
+
+const std::vector<ObserveTarget> &EnsembleStatisticsObserver::getTargets() const {
+  return this->targets;
+}
+
+unsigned long EnsembleStatisticsObserver::getNumTimePoints() const {
+  return this->workers[0].times.size();
+}
+
+double EnsembleStatisticsObserver::getTime(unsigned long timeIndex) const {
+  return this->workers[0].times[timeIndex];
+}
+
+const RunningStatistics &EnsembleStatisticsObserver::getStatistics(unsigned long timeIndex,
+                                                                    unsigned int targetIndex) const {
+  return this->workers[0].accumulators[timeIndex * this->targets.size() + targetIndex].statistics;
+}
+
+const QuantileSketch &EnsembleStatisticsObserver::getQuantiles(unsigned long timeIndex,
+                                                                unsigned int targetIndex) const {
+  return this->workers[0].accumulators[timeIndex * this->targets.size() + targetIndex].quantiles;
+}
@@ -0,0 +1,24 @@
+#include "sbmlsim/internal/observer/FunctionObserver.h"
+
+FunctionObserver::FunctionObserver(const std::vector<ObserveTarget> &targets, const SBMLSystem *system,
+                                   const Function &function)
+    : targets(targets), system(system), function(function), values(targets.size()) {
+  // nothing to do
+}
+
+FunctionObserver::FunctionObserver(const FunctionObserver &observer)
+    : targets(observer.targets), system(observer.system), function(observer.function), values(observer.values) {
+  // nothing to do
+}
+
+FunctionObserver::~FunctionObserver() {
+  // nothing to do
+}
+
+void FunctionObserver::operator()(const SBMLSystem::state &x, double t) {
+  for (unsigned int i = 0; i < this->targets.size(); i++) {
+    auto index = this->targets[i].getStateIndex();
+    this->values[i] = this->targets[i].isParameter() ? this->system->getParameterValue(index) : x[index];
+  }
+  this->function(t, this->values);
+}
@@ -1,12 +1,12 @@
 #include "sbmlsim/internal/observer/ObserveTarget.h"
 
-ObserveTarget::ObserveTarget(const std::string &id, unsigned int stateIndex)
-    : id(id), stateIndex(stateIndex) {
+ObserveTarget::ObserveTarget(const std::string &id, unsigned int stateIndex, bool parameter)
+    : id(id), stateIndex(stateIndex), parameter(parameter) {
   // nothing to do
 }
 
 ObserveTarget::ObserveTarget(const ObserveTarget &observeTarget)
-    : id(observeTarget.id), stateIndex(observeTarget.stateIndex) {
+    : id(observeTarget.id), stateIndex(observeTarget.stateIndex), parameter(observeTarget.parameter) {
   // nothing to do
 }
 
@@ -21,3 +21,7 @@ const std::string &ObserveTarget::getId() const {
 unsigned int ObserveTarget::getStateIndex() const {
   return this->stateIndex;
 }
+
+bool ObserveTarget::isParameter() const {
+  return this->parameter;
+}
@@ -3,13 +3,13 @@
 
 #define OUTPUT_PRECISION 15
 
-StdoutCsvObserver::StdoutCsvObserver(const std::vector<ObserveTarget> &targets)
-    : targets(targets) {
+StdoutCsvObserver::StdoutCsvObserver(const std::vector<ObserveTarget> &targets, const SBMLSystem *system)
+    : targets(targets), system(system) {
   // nothing to do
 }
 
 StdoutCsvObserver::StdoutCsvObserver(const StdoutCsvObserver &observer)
-    : targets(observer.targets) {
+    : targets(observer.targets), system(observer.system) {
   // nothing to do
 }
 
@@ -26,7 +26,11 @@ void StdoutCsvObserver::outputState(const SBMLSystem::state &x, double t) {
   std::cout << std::setprecision(OUTPUT_PRECISION);
   for (auto target : this->targets) {
     auto index = target.getStateIndex();
-    std::cout << "," << x[index];
+    if (target.isParameter()) {
+      std::cout << "," << this->system->getParameterValue(index);
+    } else {
+      std::cout << "," << x[index];
+    }
   }
   std::cout << std::endl;
 }
@@ -0,0 +1,122 @@
+#include "sbmlsim/internal/parallel/WorkStealingScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+WorkStealingScheduler::WorkStealingScheduler(unsigned int numThreads) : numThreads(numThreads) {
+  if (this->numThreads == 0) {
+    this->numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+}
+
+WorkStealingScheduler::WorkStealingScheduler(const WorkStealingScheduler &scheduler)
+    : numThreads(scheduler.numThreads) {
+  // nothing to do
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+  // nothing to do
+}
+
+unsigned int WorkStealingScheduler::getNumThreads() const {
+  return this->numThreads;
+}
+
+unsigned long WorkStealingScheduler::run(unsigned long numTasks, const Task &task) const {
+  auto numWorkers = static_cast<unsigned int>(std::max(std::min<unsigned long>(this->numThreads, numTasks), 1ul));
+
+  // contiguous initial blocks, so that neighbouring rows stay on one worker unless stolen
+  std::vector<std::unique_ptr<Block> > blocks;
+  for (unsigned int worker = 0; worker < numWorkers; worker++) {
+    blocks.emplace_back(new Block());
+    blocks[worker]->begin = numTasks * worker / numWorkers;
+    blocks[worker]->end = numTasks * (worker + 1) / numWorkers;
+  }
+
+  std::atomic<unsigned long> numSteals(0);
+  std::atomic<bool> failed(false);
+  std::vector<std::exception_ptr> errors(numWorkers);
+  auto work = [&](unsigned int worker) {
+    try {
+      unsigned long index;
+      while (!failed) {
+        if (!takeFront(*blocks[worker], index)) {
+          if (!steal(blocks, worker, index)) {
+            break;
+          }
+          numSteals++;
+        }
+        task(worker, index);
+      }
+    } catch (...) {
+      errors[worker] = std::current_exception();
+      failed = true;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int worker = 1; worker < numWorkers; worker++) {
+    threads.emplace_back(work, worker);
+  }
+  work(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  return numSteals;
+}
+
+bool WorkStealingScheduler::takeFront(Block &block, unsigned long &index) {
+  std::lock_guard<std::mutex> lock(block.mutex);
+  if (block.begin == block.end) {
+    return false;
+  }
+  index = block.begin++;
+  return true;
+}
+
+bool WorkStealingScheduler::steal(std::vector<std::unique_ptr<Block> > &blocks, unsigned int worker,
+                                  unsigned long &index) {
+  while (true) {
+    // the victim with the most work left; its size may change before it is locked again
+    unsigned int victim = worker;
+    unsigned long largest = 0;
+    for (unsigned int i = 0; i < blocks.size(); i++) {
+      if (i == worker) {
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(blocks[i]->mutex);
+      if (blocks[i]->end - blocks[i]->begin > largest) {
+        largest = blocks[i]->end - blocks[i]->begin;
+        victim = i;
+      }
+    }
+    if (victim == worker) {
+      // indices a thief has taken but not yet stored are run by that thief
+      return false;
+    }
+
+    unsigned long begin, end;
+    {
+      std::lock_guard<std::mutex> lock(blocks[victim]->mutex);
+      auto remaining = blocks[victim]->end - blocks[victim]->begin;
+      if (remaining == 0) {
+        continue;
+      }
+      end = blocks[victim]->end;
+      begin = end - (remaining + 1) / 2;
+      blocks[victim]->end = begin;
+    }
+    index = begin;
+    std::lock_guard<std::mutex> lock(blocks[worker]->mutex);
+    blocks[worker]->begin = begin + 1;
+    blocks[worker]->end = end;
+    return true;
+  }
+}
@@ -0,0 +1,133 @@
+#include "sbmlsim/internal/statistics/QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+QuantileSketch::QuantileSketch(unsigned int capacity)
+    : capacity(std::max(capacity, 2u)), count(0), size(0), limit(0) {
+  addLevel();
+}
+
+QuantileSketch::QuantileSketch(const QuantileSketch &sketch)
+    : capacity(sketch.capacity), count(sketch.count), levels(sketch.levels), keepOdd(sketch.keepOdd),
+      levelCapacities(sketch.levelCapacities), size(sketch.size), limit(sketch.limit) {
+  // nothing to do
+}
+
+QuantileSketch &QuantileSketch::operator=(const QuantileSketch &sketch) {
+  this->capacity = sketch.capacity;
+  this->count = sketch.count;
+  this->levels = sketch.levels;
+  this->keepOdd = sketch.keepOdd;
+  this->levelCapacities = sketch.levelCapacities;
+  this->size = sketch.size;
+  this->limit = sketch.limit;
+  return *this;
+}
+
+QuantileSketch::~QuantileSketch() {
+  // nothing to do
+}
+
+void QuantileSketch::add(double value) {
+  this->levels[0].push_back(value);
+  this->count++;
+  this->size++;
+  if (this->size > this->limit) {
+    compact();
+  }
+}
+
+void QuantileSketch::merge(const QuantileSketch &sketch) {
+  while (this->levels.size() < sketch.levels.size()) {
+    addLevel();
+  }
+  for (unsigned int h = 0; h < sketch.levels.size(); h++) {
+    this->levels[h].insert(this->levels[h].end(), sketch.levels[h].begin(), sketch.levels[h].end());
+  }
+  this->count += sketch.count;
+  this->size += sketch.size;
+  compact();
+}
+
+unsigned long QuantileSketch::getCount() const {
+  return this->count;
+}
+
+unsigned long QuantileSketch::getSize() const {
+  return this->size;
+}
+
+double QuantileSketch::getQuantile(double probability) const {
+  if (this->count == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  std::vector<std::pair<double, double> > weighted;
+  double weight = 1.0;
+  for (auto &level : this->levels) {
+    for (auto value : level) {
+      weighted.emplace_back(value, weight);
+    }
+    weight *= 2.0;
+  }
+  std::sort(weighted.begin(), weighted.end());
+  double rank = probability * static_cast<double>(this->count);
+  double cumulative = 0.0;
+  for (auto &item : weighted) {
+    cumulative += item.second;
+    if (cumulative >= rank) {
+      return item.first;
+    }
+  }
+  return weighted.back().first;
+}
+
+void QuantileSketch::addLevel() {
+  this->levels.emplace_back();
+  this->keepOdd.push_back(false);
+  // the top level keeps capacity, each one below it 2/3 of the one above
+  this->levelCapacities.resize(this->levels.size());
+  this->limit = 0;
+  for (unsigned int h = 0; h < this->levels.size(); h++) {
+    auto depth = this->levels.size() - 1 - h;
+    auto levelCapacity = std::ceil(this->capacity * std::pow(2.0 / 3.0, static_cast<double>(depth)));
+    this->levelCapacities[h] = std::max(static_cast<unsigned int>(levelCapacity), 2u);
+    this->limit += this->levelCapacities[h];
+  }
+}
+
+void QuantileSketch::compact() {
+  // the lowest level over its own limit moves up until the whole sketch is within its limit; compacting
+  // no more than that keeps the lower levels filled after a new top level has lowered their limits
+  while (this->size > this->limit) {
+    auto h = 0;
+    while (this->levels[h].size() <= this->levelCapacities[h]) {
+      h++;
+    }
+    compactLevel(h);
+  }
+}
+
+void QuantileSketch::compactLevel(unsigned int h) {
+  // an odd value out stays on its level, so the total weight stays equal to count
+  if (h + 1 == this->levels.size()) {
+    addLevel();
+  }
+  auto &level = this->levels[h];
+  std::sort(level.begin(), level.end());
+  auto &next = this->levels[h + 1];
+  auto pairs = level.size() / 2;
+  auto offset = this->keepOdd[h] ? 1 : 0;
+  for (unsigned int i = 0; i < pairs; i++) {
+    next.push_back(level[2 * i + offset]);
+  }
+  this->keepOdd[h] = !this->keepOdd[h];
+  this->size -= pairs;
+  if (level.size() % 2 == 1) {
+    level[0] = level.back();
+    level.resize(1);
+  } else {
+    level.clear();
+  }
+}
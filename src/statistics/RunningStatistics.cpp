@@ -0,0 +1,90 @@
+#include "sbmlsim/internal/statistics/RunningStatistics.h"
+#include <cmath>
+#include <limits>
+
+RunningStatistics::RunningStatistics()
+    : count(0), mean(0.0), m2(0.0), min(std::numeric_limits<double>::infinity()),
+      max(-std::numeric_limits<double>::infinity()) {
+  // nothing to do
+}
+
+RunningStatistics::RunningStatistics(const RunningStatistics &statistics)
+    : count(statistics.count), mean(statistics.mean), m2(statistics.m2), min(statistics.min), max(statistics.max) {
+  // nothing to do
+}
+
+RunningStatistics &RunningStatistics::operator=(const RunningStatistics &statistics) {
+  this->count = statistics.count;
+  this->mean = statistics.mean;
+  this->m2 = statistics.m2;
+  this->min = statistics.min;
+  this->max = statistics.max;
+  return *this;
+}
+
+RunningStatistics::~RunningStatistics() {
+  // nothing to do
+}
+
+void RunningStatistics::add(double value) {
+  this->count++;
+  double delta = value - this->mean;
+  this->mean += delta / static_cast<double>(this->count);
+  this->m2 += delta * (value - this->mean);
+  if (value < this->min) {
+    this->min = value;
+  }
+  if (value > this->max) {
+    this->max = value;
+  }
+}
+
+void RunningStatistics::merge(const RunningStatistics &statistics) {
+  if (statistics.count == 0) {
+    return;
+  }
+  if (this->count == 0) {
+    *this = statistics;
+    return;
+  }
+  double n1 = static_cast<double>(this->count);
+  double n2 = static_cast<double>(statistics.count);
+  double n = n1 + n2;
+  double delta = statistics.mean - this->mean;
+  this->mean += delta * n2 / n;
+  this->m2 += statistics.m2 + delta * delta * n1 * n2 / n;
+  this->count += statistics.count;
+  if (statistics.min < this->min) {
+    this->min = statistics.min;
+  }
+  if (statistics.max > this->max) {
+    this->max = statistics.max;
+  }
+}
+
+unsigned long RunningStatistics::getCount() const {
+  return this->count;
+}
+
+double RunningStatistics::getMean() const {
+  return this->mean;
+}
+
+double RunningStatistics::getVariance() const {
+  if (this->count < 2) {
+    return 0.0;
+  }
+  return this->m2 / static_cast<double>(this->count - 1);
+}
+
+double RunningStatistics::getStandardDeviation() const {
+  return std::sqrt(getVariance());
+}
+
+double RunningStatistics::getMin() const {
+  return this->min;
+}
+
+double RunningStatistics::getMax() const {
+  return this->max;
+}
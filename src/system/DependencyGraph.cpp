@@ -0,0 +1,81 @@
+#include "sbmlsim/internal/system/DependencyGraph.h"
+#include <functional>
+#include <queue>
+
+DependencyGraph::DependencyGraph(unsigned int numNodes) : successors(numNodes), predecessors(numNodes) {
+  // nothing to do
+}
+
+DependencyGraph::DependencyGraph(const DependencyGraph &graph)
+    : successors(graph.successors), predecessors(graph.predecessors) {
+  // nothing to do
+}
+
+DependencyGraph::~DependencyGraph() {
+  this->successors.clear();
+  this->predecessors.clear();
+}
+
+void DependencyGraph::addEdge(unsigned int from, unsigned int to) {
+  this->successors[from].push_back(to);
+  this->predecessors[to].push_back(from);
+}
+
+unsigned int DependencyGraph::getNumNodes() const {
+  return this->successors.size();
+}
+
+const std::vector<unsigned int> &DependencyGraph::getSuccessors(unsigned int node) const {
+  return this->successors[node];
+}
+
+const std::vector<unsigned int> &DependencyGraph::getPredecessors(unsigned int node) const {
+  return this->predecessors[node];
+}
+
+void DependencyGraph::collectDependencies(unsigned int node, std::vector<bool> &collected) const {
+  std::vector<unsigned int> pending(1, node);
+  collected[node] = true;
+  while (!pending.empty()) {
+    auto current = pending.back();
+    pending.pop_back();
+    for (auto predecessor : this->predecessors[current]) {
+      if (!collected[predecessor]) {
+        collected[predecessor] = true;
+        pending.push_back(predecessor);
+      }
+    }
+  }
+}
+
+bool DependencyGraph::sortTopologically(std::vector<unsigned int> &order) const {
+  auto numNodes = this->successors.size();
+  std::vector<unsigned int> inDegrees(numNodes, 0);
+  for (auto &nodes : this->successors) {
+    for (auto node : nodes) {
+      inDegrees[node]++;
+    }
+  }
+
+  // Kahn's algorithm; a min-heap keeps independent nodes in index order
+  std::priority_queue<unsigned int, std::vector<unsigned int>, std::greater<unsigned int> > ready;
+  for (unsigned int i = 0; i < numNodes; i++) {
+    if (inDegrees[i] == 0) {
+      ready.push(i);
+    }
+  }
+
+  order.clear();
+  while (!ready.empty()) {
+    auto node = ready.top();
+    ready.pop();
+    order.push_back(node);
+    for (auto successor : this->successors[node]) {
+      if (--inDegrees[successor] == 0) {
+        ready.push(successor);
+      }
+    }
+  }
+
+  return order.size() == numNodes;
+}
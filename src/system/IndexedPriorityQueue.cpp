@@ -0,0 +1,96 @@
+#include "sbmlsim/internal/system/IndexedPriorityQueue.h"
+#include <limits>
+
+IndexedPriorityQueue::IndexedPriorityQueue(unsigned int size)
+    : keys(size, std::numeric_limits<double>::infinity()), heap(size), positions(size) {
+  for (unsigned int i = 0; i < size; i++) {
+    this->heap[i] = i;
+    this->positions[i] = i;
+  }
+}
+
+IndexedPriorityQueue::IndexedPriorityQueue(const IndexedPriorityQueue &queue)
+    : keys(queue.keys), heap(queue.heap), positions(queue.positions) {
+  // nothing to do
+}
+
+IndexedPriorityQueue::~IndexedPriorityQueue() {
+  // nothing to do
+}
+
+void IndexedPriorityQueue::build(const std::vector<double> &keys) {
+  this->keys = keys;
+  for (unsigned int i = 0; i < this->heap.size(); i++) {
+    this->heap[i] = i;
+    this->positions[i] = i;
+  }
+  for (auto position = this->heap.size() / 2; position > 0; position--) {
+    siftDown(position - 1);
+  }
+}
+
+void IndexedPriorityQueue::update(unsigned int item, double key) {
+  double previous = this->keys[item];
+  this->keys[item] = key;
+  if (key < previous) {
+    siftUp(this->positions[item]);
+  } else {
+    siftDown(this->positions[item]);
+  }
+}
+
+unsigned int IndexedPriorityQueue::getTop() const {
+  return this->heap[0];
+}
+
+double IndexedPriorityQueue::getTopKey() const {
+  return this->keys[this->heap[0]];
+}
+
+double IndexedPriorityQueue::getKey(unsigned int item) const {
+  return this->keys[item];
+}
+
+unsigned int IndexedPriorityQueue::getSize() const {
+  return this->heap.size();
+}
+
+void IndexedPriorityQueue::siftUp(unsigned int position) {
+  while (position > 0) {
+    auto parent = (position - 1) / 2;
+    if (!(this->keys[this->heap[position]] < this->keys[this->heap[parent]])) {
+      break;
+    }
+    swap(position, parent);
+    position = parent;
+  }
+}
+
+void IndexedPriorityQueue::siftDown(unsigned int position) {
+  auto size = this->heap.size();
+  while (true) {
+    auto smallest = position;
+    auto left = 2 * position + 1;
+    auto right = left + 1;
+    if (left < size && this->keys[this->heap[left]] < this->keys[this->heap[smallest]]) {
+      smallest = left;
+    }
+    if (right < size && this->keys[this->heap[right]] < this->keys[this->heap[smallest]]) {
+      smallest = right;
+    }
+    if (smallest == position) {
+      break;
+    }
+    swap(position, smallest);
+    position = smallest;
+  }
+}
+
+void IndexedPriorityQueue::swap(unsigned int position1, unsigned int position2) {
+  auto item1 = this->heap[position1];
+  auto item2 = this->heap[position2];
+  this->heap[position1] = item2;
+  this->heap[position2] = item1;
+  this->positions[item1] = position2;
+  this->positions[item2] = position1;
+}
@@ -0,0 +1,88 @@
+#include "sbmlsim/internal/system/JacobianColoring.h"
+#include <algorithm>
+
+JacobianColoring::JacobianColoring(unsigned int numRows, unsigned int numColumns)
+    : numRows(numRows), numColumns(numColumns), numColors(0), columns(numColumns) {
+  // nothing to do
+}
+
+JacobianColoring::JacobianColoring(const JacobianColoring &coloring)
+    : numRows(coloring.numRows), numColumns(coloring.numColumns), numColors(coloring.numColors),
+      columns(coloring.columns), colors(coloring.colors), columnPointers(coloring.columnPointers),
+      rowIndices(coloring.rowIndices) {
+  // nothing to do
+}
+
+JacobianColoring::~JacobianColoring() {
+  // nothing to do
+}
+
+void JacobianColoring::add(unsigned int row, unsigned int column) {
+  this->columns[column].push_back(row);
+}
+
+void JacobianColoring::color() {
+  // CSC without duplicates
+  this->columnPointers.assign(1, 0);
+  this->rowIndices.clear();
+  for (auto &rows : this->columns) {
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    this->rowIndices.insert(this->rowIndices.end(), rows.begin(), rows.end());
+    this->columnPointers.push_back(this->rowIndices.size());
+  }
+  this->columns.assign(this->numColumns, std::vector<unsigned int>());
+
+  // columns of each row
+  std::vector<std::vector<unsigned int> > rowColumns(this->numRows);
+  for (unsigned int j = 0; j < this->numColumns; j++) {
+    for (auto k = this->columnPointers[j]; k < this->columnPointers[j + 1]; k++) {
+      rowColumns[this->rowIndices[k]].push_back(j);
+    }
+  }
+
+  // greedy: smallest color not used by a column sharing a row
+  const unsigned int uncolored = this->numColumns;
+  this->colors.assign(this->numColumns, uncolored);
+  this->numColors = 0;
+  std::vector<unsigned int> forbiddenBy(this->numColumns + 1, uncolored);
+  for (unsigned int j = 0; j < this->numColumns; j++) {
+    for (auto k = this->columnPointers[j]; k < this->columnPointers[j + 1]; k++) {
+      for (auto neighbor : rowColumns[this->rowIndices[k]]) {
+        if (this->colors[neighbor] != uncolored) {
+          forbiddenBy[this->colors[neighbor]] = j;
+        }
+      }
+    }
+    unsigned int color = 0;
+    while (forbiddenBy[color] == j) {
+      color++;
+    }
+    this->colors[j] = color;
+    this->numColors = std::max(this->numColors, color + 1);
+  }
+}
+
+unsigned int JacobianColoring::getNumRows() const {
+  return this->numRows;
+}
+
+unsigned int JacobianColoring::getNumColumns() const {
+  return this->numColumns;
+}
+
+unsigned int JacobianColoring::getNumColors() const {
+  return this->numColors;
+}
+
+const std::vector<unsigned int> &JacobianColoring::getColors() const {
+  return this->colors;
+}
+
+const std::vector<unsigned int> &JacobianColoring::getColumnPointers() const {
+  return this->columnPointers;
+}
+
+const std::vector<unsigned int> &JacobianColoring::getRowIndices() const {
+  return this->rowIndices;
+}
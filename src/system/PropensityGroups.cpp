@@ -0,0 +1,100 @@
+#include "sbmlsim/internal/system/PropensityGroups.h"
+#include <algorithm>
+
+const int PropensityGroups::MIN_EXPONENT;
+const int PropensityGroups::NUM_EXPONENTS;
+const unsigned int PropensityGroups::NONE;
+
+PropensityGroups::PropensityGroups(unsigned int numReactions)
+    : propensities(numReactions, 0.0), groupOf(numReactions, NONE), positions(numReactions, 0),
+      groups(NUM_EXPONENTS), minGroup(NUM_EXPONENTS), maxGroup(0) {
+  // nothing to do
+}
+
+PropensityGroups::PropensityGroups(const PropensityGroups &groups)
+    : propensities(groups.propensities), groupOf(groups.groupOf), positions(groups.positions),
+      groups(groups.groups), minGroup(groups.minGroup), maxGroup(groups.maxGroup) {
+  // nothing to do
+}
+
+PropensityGroups::~PropensityGroups() {
+  // nothing to do
+}
+
+void PropensityGroups::update(unsigned int reaction, double propensity) {
+  auto group = findGroup(propensity);
+  if (group == this->groupOf[reaction]) {
+    if (group != NONE) {
+      this->groups[group].sum += propensity - this->propensities[reaction];
+    }
+    this->propensities[reaction] = propensity;
+    return;
+  }
+  remove(reaction);
+  this->propensities[reaction] = propensity;
+  if (group != NONE) {
+    insert(reaction, group);
+  }
+}
+
+double PropensityGroups::getTotal() const {
+  double total = 0.0;
+  for (auto g = this->minGroup; g <= this->maxGroup && g < NUM_EXPONENTS; g++) {
+    total += this->groups[g].sum;
+  }
+  return total;
+}
+
+double PropensityGroups::getPropensity(unsigned int reaction) const {
+  return this->propensities[reaction];
+}
+
+unsigned int PropensityGroups::findGroup(double propensity) const {
+  if (propensity <= 0.0) {
+    return NONE;
+  }
+  // propensity = m * 2^exponent with m in [0.5, 1); subnormals share the lowest group
+  int exponent;
+  std::frexp(propensity, &exponent);
+  return std::max(exponent, MIN_EXPONENT) - MIN_EXPONENT;
+}
+
+void PropensityGroups::insert(unsigned int reaction, unsigned int group) {
+  auto &members = this->groups[group];
+  this->groupOf[reaction] = group;
+  this->positions[reaction] = members.reactions.size();
+  members.reactions.push_back(reaction);
+  members.sum += this->propensities[reaction];
+  this->minGroup = std::min(this->minGroup, group);
+  this->maxGroup = std::max(this->maxGroup, group);
+}
+
+void PropensityGroups::remove(unsigned int reaction) {
+  auto group = this->groupOf[reaction];
+  if (group == NONE) {
+    return;
+  }
+  auto &members = this->groups[group];
+  auto last = members.reactions.back();
+  members.reactions[this->positions[reaction]] = last;
+  this->positions[last] = this->positions[reaction];
+  members.reactions.pop_back();
+  this->groupOf[reaction] = NONE;
+
+  if (!members.reactions.empty()) {
+    members.sum -= this->propensities[reaction];
+    return;
+  }
+  // no round-off is left behind in an empty group
+  members.sum = 0.0;
+  while (this->minGroup <= this->maxGroup && this->groups[this->minGroup].reactions.empty()) {
+    this->minGroup++;
+  }
+  while (this->maxGroup > this->minGroup && this->groups[this->maxGroup].reactions.empty()) {
+    this->maxGroup--;
+  }
+  if (this->minGroup > this->maxGroup) {
+    this->minGroup = NUM_EXPONENTS;
+    this->maxGroup = 0;
+  }
+}
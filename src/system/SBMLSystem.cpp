@@ -1,151 +1,267 @@
 #include "sbmlsim/internal/system/SBMLSystem.h"
 #include <algorithm>
-#include "sbmlsim/internal/util/MathUtil.h"
+#include <set>
+#include <unordered_set>
+#include <utility>
+#include "sbmlsim/internal/bytecode/BytecodeCompiler.h"
+#include "sbmlsim/internal/bytecode/BytecodeInterpreter.h"
+#include "sbmlsim/internal/bytecode/DualInterpreter.h"
 #include "sbmlsim/internal/util/ASTNodeUtil.h"
+#include "sbmlsim/internal/util/MathUtil.h"
 #include "sbmlsim/internal/util/RuntimeExceptionUtil.h"
 
-SBMLSystem::SBMLSystem(const ModelWrapper *model) : model(const_cast<ModelWrapper *>(model)) {
+// name that stands for time while differentiating
+#define JACOBIAN_TIME_SYMBOL "__sbmlsim_time"
+// events executed in turn at one time, each round triggered by the assignments of the one before
+#define MAX_EVENT_ROUNDS 100
+
+SBMLSystem::SBMLSystem(const ModelWrapper *model) : model(model), compiled(std::make_shared<CompiledModel>()) {
   prepareInitialState();
+  compileModel();
 }
 
 SBMLSystem::SBMLSystem(const SBMLSystem &system)
-    : model(system.model), initialState(system.initialState), stateIndexMap(system.stateIndexMap) {
+    : model(system.model), compiled(system.compiled), bytecode(system.bytecode),
+      stoichiometryMatrix(system.stoichiometryMatrix), reactantMatrix(system.reactantMatrix),
+      assignmentRuleGraph(system.assignmentRuleGraph),
+      reactionDependencyGraph(system.reactionDependencyGraph), initialState(system.initialState),
+      parameters(system.parameters), stack(system.stack), reactionRates(system.reactionRates),
+      stoichiometryChanges(system.stoichiometryChanges),
+      dualStack(system.dualStack), parameterTangents(system.parameterTangents),
+      reactionRateTangents(system.reactionRateTangents), requiredAssignmentRules(system.requiredAssignmentRules),
+      assignmentRuleSequence(system.assignmentRuleSequence), eventTriggerStates(system.eventTriggerStates),
+      pendingEvents(system.pendingEvents), eventAssignmentValues(system.eventAssignmentValues) {
   // nothing to do
 }
 
 SBMLSystem::~SBMLSystem() {
   this->initialState.clear();
-  this->stateIndexMap.clear();
+  this->parameters.clear();
 }
 
 void SBMLSystem::operator()(const state &x, state &dxdt, double t) {
+  (*this)(x.data().begin(), dxdt.data().begin(), t);
+}
+
+void SBMLSystem::operator()(const double *x, double *dxdt, double t) {
+  handleRhsAssignmentRule(x, t);
   handleReaction(x, dxdt, t);
 }
 
-void SBMLSystem::handleReaction(const state& x, state& dxdt, double t) {
-  // initialize
-  for (auto i = 0; i < dxdt.size(); i++) {
-    dxdt[i] = 0.0;
+void SBMLSystem::handleReaction(const state &x, state &dxdt, double t) {
+  handleReaction(x.data().begin(), dxdt.data().begin(), t);
+}
+
+void SBMLSystem::handleReaction(const double *x, double *dxdt, double t) {
+  // reaction rates
+  auto numReactions = this->compiled->reactionExpressions.size();
+  for (unsigned int i = 0; i < numReactions; i++) {
+    this->reactionRates[i] = evaluateExpression(this->compiled->reactionExpressions[i], x, t);
   }
 
-  auto reactions = model->getReactions();
-  for (auto i = 0; i < reactions.size(); i++) {
-    auto reaction = reactions[i];
-    auto node = reaction.getMath();
+  // dxdt = N * v
+  this->stoichiometryMatrix->multiply(this->reactionRates.data(), dxdt);
+  for (auto &entry : this->compiled->variableStoichiometries) {
+    dxdt[entry.row] += entry.sign * this->reactionRates[entry.reaction] * evaluateExpression(entry.expressionId, x, t);
+  }
 
-    auto clonedNode = ASTNodeUtil::reduceToBinary(node);
-    auto value = evaluateASTNode(clonedNode, x, t);
-    delete clonedNode;
+  // rate rule
+  handleRateRule(x, dxdt, t);
+}
 
-    // reactants
-    for (auto reactant : reaction.getReactants()) {
-      auto index = getStateIndexForVariable(reactant.getSpeciesId());
-      double stoichiometry;
-      if (reactant.hasStoichiometryMath()) {
-        stoichiometry = evaluateASTNode(reactant.getStoichiometryMath(), x, t);
-      } else {
-        stoichiometry = reactant.getStoichiometry();
-      }
-      dxdt[index] -= value * stoichiometry;
+bool SBMLSystem::handleEvent(state &x, double t) {
+  // rounds until no trigger becomes true: events may trigger others through their assignments
+  bool fired = false;
+  for (unsigned int round = 0; ; round++) {
+    if (round > 0) {
+      // triggers may read assignment rules
+      handleAssignmentRule(x, t);
     }
-
-    // products
-    for (auto product : reaction.getProducts()) {
-      auto index = getStateIndexForVariable(product.getSpeciesId());
-      double stoichiometry;
-      if (product.hasStoichiometryMath()) {
-        stoichiometry = evaluateASTNode(product.getStoichiometryMath(), x, t);
-      } else {
-        stoichiometry = product.getStoichiometry();
+    // every trigger is checked before any event executes
+    bool pending = false;
+    for (unsigned int i = 0; i < this->eventTriggerStates.size(); i++) {
+      bool fire = evaluateExpression(this->compiled->eventTriggerExpressions[i], x, t) != 0.0;
+      this->pendingEvents[i] = fire && !this->eventTriggerStates[i];
+      pending = pending || this->pendingEvents[i];
+      if (!fire) {
+        this->eventTriggerStates[i] = false;
       }
-      dxdt[index] += value * stoichiometry;
     }
+    if (!pending) {
+      return fired;
+    }
+    if (round == MAX_EVENT_ROUNDS) {
+      RuntimeExceptionUtil::throwIntegrationException("events keep triggering each other");
+    }
+    executeEvents(x, t);
+    fired = true;
   }
+}
 
-  // boundaryCondition
-  auto &specieses = model->getSpecieses();
-  for (auto i = 0; i < specieses.size(); i++) {
-    if (specieses[i].hasBoundaryCondition()) {
-      auto index = getStateIndexForVariable(specieses[i].getId());
-      dxdt[index] = 0.0;
-    }
+unsigned int SBMLSystem::getNumEvents() const {
+  return this->compiled->eventRootExpressions.size();
+}
+
+void SBMLSystem::evaluateEventRoots(state &x, double t, std::vector<double> &roots) {
+  // triggers may read assignment rules
+  handleAssignmentRule(x, t);
+  for (unsigned int i = 0; i < this->compiled->eventRootExpressions.size(); i++) {
+    roots[i] = evaluateExpression(this->compiled->eventRootExpressions[i], x, t);
   }
+}
 
-  // rate rule
-  handleRateRule(x, dxdt, t);
+void SBMLSystem::setEventTriggerStates(const std::vector<double> &roots) {
+  for (unsigned int i = 0; i < this->eventTriggerStates.size(); i++) {
+    this->eventTriggerStates[i] = roots[i] > 0.0;
+  }
+}
 
-  // constant
-  for (auto i = 0; i < specieses.size(); i++) {
-    if (specieses[i].isConstant()) {
-      auto index = getStateIndexForVariable(specieses[i].getId());
-      dxdt[index] = 0.0;
+void SBMLSystem::executeEvents(state &x, double t) {
+  // events have no delays, so all assignments of the pending events use the values from before any of them
+  auto &events = this->model->getEvents();
+  for (unsigned int i = 0; i < this->pendingEvents.size(); i++) {
+    if (!this->pendingEvents[i]) {
+      continue;
     }
+    auto &expressionIds = this->compiled->eventAssignmentExpressions[i];
+    for (unsigned int j = 0; j < expressionIds.size(); j++) {
+      this->eventAssignmentValues[i][j] = evaluateExpression(expressionIds[j], x, t);
+    }
+  }
+  for (unsigned int i = 0; i < this->pendingEvents.size(); i++) {
+    if (!this->pendingEvents[i]) {
+      continue;
+    }
+    auto &eventAssignments = events[i]->getEventAssignments();
+    for (unsigned int j = 0; j < eventAssignments.size(); j++) {
+      setVariableValue(x, eventAssignments[j].getVariable(), this->eventAssignmentValues[i][j]);
+    }
+    this->eventTriggerStates[i] = true;
   }
 }
 
-void SBMLSystem::handleEvent(state &x, double t) {
-  for (auto event : model->getEvents()) {
-    bool fire = evaluateConditionalNode(event->getTrigger(), x, t);
-    if (fire && event->getTriggerState() == false) {
-      for (auto eventAssignment : event->getEventAssignments()) {
-        auto variable = eventAssignment.getVariable();
-        auto index = getStateIndexForVariable(variable);
-        double value = evaluateASTNode(eventAssignment.getMath(), x, t);
-        x[index] = value;
-        event->setTriggerState(true);
-      }
-    } else if (!fire) {
-      event->setTriggerState(false);
-    }
+unsigned int SBMLSystem::getNumReactions() const {
+  return this->compiled->reactionExpressions.size();
+}
+
+bool SBMLSystem::hasRateRules() const {
+  return !this->compiled->rateRuleExpressions.empty();
+}
+
+void SBMLSystem::evaluatePropensities(const state &x, double t, std::vector<double> &propensities) {
+  handleRhsAssignmentRule(x.data().begin(), t);
+  for (unsigned int i = 0; i < this->compiled->reactionExpressions.size(); i++) {
+    propensities[i] = evaluateExpression(this->compiled->reactionExpressions[i], x, t);
   }
 }
 
-void SBMLSystem::handleInitialAssignment(state &x, double t) {
-  if (t > 0) {
-    return;
-  }
-
-  for (auto initialAssignment : model->getInitialAssignments()) {
-    auto symbol = initialAssignment->getSymbol();
-    auto value = evaluateASTNode(initialAssignment->getMath(), x, t);
-
-    // species
-    auto specieses = model->getSpecieses();
-    for (auto i = 0; i < specieses.size(); i++) {
-      if (symbol == specieses[i].getId()) {
-        auto speciesIndex = getStateIndexForVariable(specieses[i].getId());
-        if (specieses[i].shouldMultiplyByCompartmentSizeOnAssignment()) {
-          auto compartments = model->getCompartments();
-          for (auto j = 0; j < compartments.size(); j++) {
-            if (specieses[i].getCompartmentId() == compartments[j].getId()) {
-              auto compartmentIndex = getStateIndexForVariable(compartments[j].getId());
-              x[speciesIndex] = value * x[compartmentIndex];
-            }
-          }
-        } else {
-          x[speciesIndex] = value;
-        }
-      }
-    }
+void SBMLSystem::evaluatePropensities(const state &x, double t, const std::vector<unsigned int> &reactions,
+                                      std::vector<double> &propensities) {
+  handleRhsAssignmentRule(x.data().begin(), t);
+  for (auto i : reactions) {
+    propensities[i] = evaluateExpression(this->compiled->reactionExpressions[i], x, t);
+  }
+}
 
-    // compartment
-    auto compartments = model->getCompartments();
-    for (auto i = 0; i < compartments.size(); i++) {
-      if (symbol == compartments[i].getId()) {
-        auto index = getStateIndexForVariable(compartments[i].getId());
-        x[index] = value;
+const DependencyGraph &SBMLSystem::getReactionDependencyGraph() const {
+  return *this->reactionDependencyGraph;
+}
+
+DependencyGraph SBMLSystem::createReactionDependencyGraph() {
+  auto numReactions = this->compiled->reactionExpressions.size();
+
+  // reactions reading each state variable, directly or through assignment rules
+  std::vector<std::vector<unsigned int> > readers(this->initialState.size());
+  std::vector<unsigned int> timeDependent;
+  std::vector<unsigned int> stateIndices;
+  std::vector<unsigned int> parameterIndices;
+  for (unsigned int i = 0; i < numReactions; i++) {
+    auto expressionId = this->compiled->reactionExpressions[i];
+    stateIndices.clear();
+    parameterIndices.clear();
+    this->bytecode->collectLoads(expressionId, stateIndices, parameterIndices);
+    bool readsTime = this->bytecode->dependsOnTime(expressionId);
+    std::vector<bool> rules(this->compiled->assignmentRules.size(), false);
+    requireAssignmentRules(expressionId, rules);
+    for (unsigned int k = 0; k < rules.size(); k++) {
+      if (rules[k]) {
+        this->bytecode->collectLoads(this->compiled->assignmentRules[k].expressionId, stateIndices, parameterIndices);
+        readsTime = readsTime || this->bytecode->dependsOnTime(this->compiled->assignmentRules[k].expressionId);
       }
     }
+    std::sort(stateIndices.begin(), stateIndices.end());
+    stateIndices.erase(std::unique(stateIndices.begin(), stateIndices.end()), stateIndices.end());
+    for (auto index : stateIndices) {
+      readers[index].push_back(i);
+    }
+    // time moves with every firing
+    if (readsTime) {
+      timeDependent.push_back(i);
+    }
+  }
 
-    // global parameter
-    auto parameters = model->getParameters();
-    for (auto i = 0; i < parameters.size(); i++) {
-      if (symbol == parameters[i]->getId()) {
-        auto index = getStateIndexForVariable(parameters[i]->getId());
-        x[index] = value;
+  // reaction j affects the readers of every row it changes
+  DependencyGraph graph(numReactions);
+  auto &columnPointers = this->stoichiometryMatrix->getColumnPointers();
+  auto &rowIndices = this->stoichiometryMatrix->getRowIndices();
+  std::vector<unsigned int> lastAddedBy(numReactions, numReactions);
+  for (unsigned int j = 0; j < numReactions; j++) {
+    std::vector<unsigned int> rows(rowIndices.begin() + columnPointers[j], rowIndices.begin() + columnPointers[j + 1]);
+    auto &pointers = this->compiled->variableStoichiometryPointers;
+    for (auto k = pointers[j]; k < pointers[j + 1]; k++) {
+      rows.push_back(this->compiled->variableStoichiometries[k].row);
+    }
+    std::vector<unsigned int> affected(timeDependent);
+    for (auto row : rows) {
+      affected.insert(affected.end(), readers[row].begin(), readers[row].end());
+    }
+    for (auto i : affected) {
+      if (lastAddedBy[i] != j) {
+        lastAddedBy[i] = j;
+        graph.addEdge(j, i);
       }
     }
   }
+  return graph;
+}
+
+void SBMLSystem::fireReaction(unsigned int reaction, state &x, double t, double count) {
+  // column of N, then the stoichiometryMath of this reaction (evaluated before any change)
+  auto &columnPointers = this->stoichiometryMatrix->getColumnPointers();
+  auto &rowIndices = this->stoichiometryMatrix->getRowIndices();
+  auto &columnValues = this->stoichiometryMatrix->getColumnValues();
+  auto &entries = this->compiled->variableStoichiometries;
+  auto first = this->compiled->variableStoichiometryPointers[reaction];
+  auto last = this->compiled->variableStoichiometryPointers[reaction + 1];
+  for (auto k = first; k < last; k++) {
+    this->stoichiometryChanges[k] = entries[k].sign * evaluateExpression(entries[k].expressionId, x, t);
+  }
+  for (auto k = columnPointers[reaction]; k < columnPointers[reaction + 1]; k++) {
+    x[rowIndices[k]] += count * columnValues[k];
+  }
+  for (auto k = first; k < last; k++) {
+    x[entries[k].row] += count * this->stoichiometryChanges[k];
+  }
+}
+
+bool SBMLSystem::hasVariableStoichiometry(unsigned int reaction) const {
+  auto &pointers = this->compiled->variableStoichiometryPointers;
+  return pointers[reaction] < pointers[reaction + 1];
+}
+
+const StoichiometryMatrix &SBMLSystem::getStoichiometryMatrix() const {
+  return *this->stoichiometryMatrix;
+}
+
+const StoichiometryMatrix &SBMLSystem::getReactantMatrix() const {
+  return *this->reactantMatrix;
+}
+
+void SBMLSystem::handleInitialAssignment(state &x, double t) {
+  // initial assignments together with assignment rules
+  for (auto &assignment : this->compiled->initialAssignmentSequence) {
+    assign(x, assignment.target, evaluateExpression(assignment.expressionId, x, t));
+  }
 }
 
 void SBMLSystem::handleAlgebraicRule(state &x, double t) {
@@ -153,105 +269,316 @@ void SBMLSystem::handleAlgebraicRule(state &x, double t) {
 }
 
 void SBMLSystem::handleAssignmentRule(state &x, double t) {
-  auto &assignmentRules = this->model->getAssignmentRules();
-  for (auto i = 0; i < assignmentRules.size(); i++) {
-    auto &variable = assignmentRules[i]->getVariable();
-    auto value = evaluateASTNode(assignmentRules[i]->getMath(), x, t);
-
-    bool continueImmediately = false;
-
-    // species
-    auto specieses = model->getSpecieses();
-    for (auto i = 0; i < specieses.size(); i++) {
-      if (variable == specieses[i].getId()) {
-        auto speciesIndex = getStateIndexForVariable(specieses[i].getId());
-        if (specieses[i].shouldMultiplyByCompartmentSizeOnAssignment()) {
-          auto compartments = model->getCompartments();
-          for (auto j = 0; j < compartments.size(); j++) {
-            if (specieses[i].getCompartmentId() == compartments[j].getId()) {
-              auto compartmentIndex = getStateIndexForVariable(compartments[j].getId());
-              x[speciesIndex] = value * x[compartmentIndex];
-            }
-          }
-        } else {
-          x[speciesIndex] = value;
-        }
-        continueImmediately = true;
-        break;
-      }
+  for (auto &assignment : this->assignmentRuleSequence) {
+    assign(x, assignment.target, evaluateExpression(assignment.expressionId, x, t));
+  }
+}
+
+void SBMLSystem::handleRhsAssignmentRule(const double *x, double t) {
+  // assignment rules the RHS depends on (rule targets live in the parameter block)
+  for (auto &assignment : this->compiled->rhsAssignmentRuleSequence) {
+    auto value = evaluateExpression(assignment.expressionId, x, t);
+    this->parameters[assignment.target.index] = toAmount(x, assignment.target, value);
+  }
+}
+
+void SBMLSystem::handleRateRule(const double *x, double *dxdt, double t) {
+  for (unsigned int k = 0; k < this->compiled->rateRuleExpressions.size(); k++) {
+    // species read as concentrations change by rate * compartment size
+    auto &target = this->compiled->rateRuleTargets[k];
+    dxdt[target.index] = toAmount(x, target, evaluateExpression(this->compiled->rateRuleExpressions[k], x, t));
+  }
+}
+
+SBMLSystem::state SBMLSystem::getInitialState() {
+  return this->initialState;
+}
+
+unsigned int SBMLSystem::getStateIndexForVariable(const std::string &variableId) const {
+  auto it = this->compiled->stateIndexMap.find(variableId);
+  if (it == this->compiled->stateIndexMap.end()) {
+    RuntimeExceptionUtil::throwUnknownNodeNameException(variableId);
+  }
+  return it->second;
+}
+
+bool SBMLSystem::hasStateVariable(const std::string &variableId) const {
+  return this->compiled->stateIndexMap.count(variableId) > 0;
+}
+
+double SBMLSystem::getParameterValue(unsigned int parameterIndex) const {
+  return this->parameters[parameterIndex];
+}
+
+const std::vector<double> &SBMLSystem::getParameterValues() const {
+  return this->parameters;
+}
+
+unsigned int SBMLSystem::getSlot(const std::string &variableId) const {
+  auto parameterIt = this->compiled->parameterIndexMap.find(variableId);
+  if (parameterIt != this->compiled->parameterIndexMap.end()) {
+    return parameterIt->second;
+  }
+  auto stateIt = this->compiled->stateIndexMap.find(variableId);
+  if (stateIt == this->compiled->stateIndexMap.end()) {
+    RuntimeExceptionUtil::throwUnknownNodeNameException(variableId);
+  }
+  return this->parameters.size() + stateIt->second;
+}
+
+void SBMLSystem::setSlotValue(unsigned int slot, double value) {
+  if (slot < this->parameters.size()) {
+    this->parameters[slot] = value;
+  } else {
+    this->initialState[slot - this->parameters.size()] = value;
+  }
+}
+
+SBMLSystemJacobi SBMLSystem::createJacobi() {
+  auto bytecode = std::make_shared<Bytecode>();
+  auto speciesMap = createSpeciesMap();
+  std::vector<unsigned int> partialExpressions;
+  std::vector<JacobianEntry> entries;
+  std::vector<JacobianEntry> timeEntries;
+
+  // dxdt as a sum of terms: coefficient * math, scattered to rows
+  std::vector<ASTNode *> terms;
+  std::vector<std::vector<std::pair<unsigned int, double> > > termRows;
+
+  // reactions
+  auto &reactions = this->model->getReactions();
+  auto &columnPointers = this->stoichiometryMatrix->getColumnPointers();
+  auto &rowIndices = this->stoichiometryMatrix->getRowIndices();
+  auto &columnValues = this->stoichiometryMatrix->getColumnValues();
+  for (unsigned int i = 0; i < reactions.size(); i++) {
+    std::vector<std::pair<unsigned int, double> > rows;
+    for (auto k = columnPointers[i]; k < columnPointers[i + 1]; k++) {
+      rows.push_back(std::make_pair(rowIndices[k], columnValues[k]));
     }
-    if (continueImmediately) {
-      continue;
+    terms.push_back(reactions[i].getMath()->deepCopy());
+    termRows.push_back(rows);
+  }
+
+  // stoichiometryMath
+  for (unsigned int i = 0; i < this->compiled->variableStoichiometries.size(); i++) {
+    auto &entry = this->compiled->variableStoichiometries[i];
+    ASTNode *times = new ASTNode(AST_TIMES);
+    times->addChild(reactions[entry.reaction].getMath()->deepCopy());
+    times->addChild(this->compiled->variableStoichiometryMaths[i]->deepCopy());
+    terms.push_back(times);
+    termRows.push_back(std::vector<std::pair<unsigned int, double> >(1, std::make_pair(entry.row, entry.sign)));
+  }
+
+  // rate rules
+  for (auto rateRule : this->model->getRateRules()) {
+    auto &variable = rateRule->getVariable();
+    ASTNode *math = rateRule->getMath()->deepCopy();
+    auto speciesIt = speciesMap.find(variable);
+    if (speciesIt != speciesMap.end() && speciesIt->second->shouldMultiplyByCompartmentSizeOnAssignment()) {
+      ASTNode *times = new ASTNode(AST_TIMES);
+      ASTNode *compartment = new ASTNode(AST_NAME);
+      compartment->setName(speciesIt->second->getCompartmentId().c_str());
+      times->addChild(math);
+      times->addChild(compartment);
+      math = times;
     }
+    terms.push_back(math);
+    termRows.push_back(std::vector<std::pair<unsigned int, double> >(
+        1, std::make_pair(getStateIndexForVariable(variable), 1.0)));
+  }
 
-    // compartment
-    auto compartments = model->getCompartments();
-    for (auto i = 0; i < compartments.size(); i++) {
-      if (variable == compartments[i].getId()) {
-        auto index = getStateIndexForVariable(compartments[i].getId());
-        x[index] = value;
-        continueImmediately = true;
-        break;
-      }
+  // assignment rules are substituted into the terms
+  std::unordered_map<std::string, const ASTNode *> definitions;
+  for (auto assignmentRule : this->model->getAssignmentRules()) {
+    definitions[assignmentRule->getVariable()] = assignmentRule->getMath();
+  }
+  ASTNode time(AST_NAME_TIME);
+  std::unordered_map<std::string, const ASTNode *> timeDefinition;
+  timeDefinition[JACOBIAN_TIME_SYMBOL] = &time;
+
+  auto addPartial = [&](ASTNode *partial, const std::vector<std::pair<unsigned int, double> > &rows,
+                        bool isTime, unsigned int column, double sign) {
+    ASTNode *simplified = MathUtil::simplify(partial);
+    delete partial;
+    if ((simplified->getType() == AST_INTEGER || simplified->getType() == AST_REAL) &&
+        simplified->getValue() == 0.0) {
+      delete simplified;
+      return;
     }
-    if (continueImmediately) {
-      continue;
+    ASTNode *math = ASTNodeUtil::expandNames(simplified, timeDefinition);
+    delete simplified;
+    unsigned int partialIndex = partialExpressions.size();
+    partialExpressions.push_back(BytecodeCompiler::compile(math, *bytecode));
+    delete math;
+
+    for (auto &row : rows) {
+      JacobianEntry entry;
+      entry.row = row.first;
+      entry.column = column;
+      entry.coefficient = sign * row.second;
+      entry.partial = partialIndex;
+      (isTime ? timeEntries : entries).push_back(entry);
     }
+  };
 
-    // global parameter
-    auto parameters = model->getParameters();
-    for (auto i = 0; i < parameters.size(); i++) {
-      if (variable == parameters[i]->getId()) {
-        auto index = getStateIndexForVariable(parameters[i]->getId());
-        x[index] = value;
-        break;
+  for (unsigned int i = 0; i < terms.size(); i++) {
+    ASTNode *expanded = ASTNodeUtil::expandNames(terms[i], definitions);
+    ASTNode *f = ASTNodeUtil::rewriteTimeToName(expanded, JACOBIAN_TIME_SYMBOL);
+    delete expanded;
+    delete terms[i];
+
+    std::set<std::string> names;
+    ASTNodeUtil::collectNames(f, names);
+    for (auto &name : names) {
+      if (name == JACOBIAN_TIME_SYMBOL) {
+        addPartial(MathUtil::differentiate(f, name), termRows[i], true, 0, 1.0);
+        continue;
+      }
+
+      auto binding = createBinding(name, speciesMap);
+      if (binding.parameter) {
+        continue;
+      }
+      if (!binding.concentration) {
+        addPartial(MathUtil::differentiate(f, name), termRows[i], false, binding.index, 1.0);
+        continue;
       }
+
+      // name is a concentration: d(amount / size)/d(amount) = 1 / size, d(amount / size)/d(size) = -name / size
+      auto &compartmentId = speciesMap[name]->getCompartmentId();
+      ASTNode *divide = new ASTNode(AST_DIVIDE);
+      ASTNode *compartment = new ASTNode(AST_NAME);
+      compartment->setName(compartmentId.c_str());
+      divide->addChild(MathUtil::differentiate(f, name));
+      divide->addChild(compartment);
+      if (!binding.compartmentParameter) {
+        ASTNode *times = new ASTNode(AST_TIMES);
+        ASTNode *species = new ASTNode(AST_NAME);
+        species->setName(name.c_str());
+        times->addChild(divide->deepCopy());
+        times->addChild(species);
+        addPartial(times, termRows[i], false, binding.compartmentIndex, -1.0);
+      }
+      addPartial(divide, termRows[i], false, binding.index, 1.0);
     }
+    delete f;
   }
+
+  bindSymbols(*bytecode);
+  return SBMLSystemJacobi(this, bytecode, partialExpressions, entries, timeEntries);
 }
 
-void SBMLSystem::handleRateRule(const state &x, state &dxdt, double t) {
-  for (auto rateRule : model->getRateRules()) {
-    auto &variableName = rateRule->getVariable();
-    auto value = evaluateASTNode(rateRule->getMath(), x, t);
-    auto index = getStateIndexForVariable(variableName);
-
-    // species
-    bool continueImmediately = false;
-    auto &specieses = model->getSpecieses();
-    for (auto i = 0; i < specieses.size(); i++) {
-      if (variableName == specieses[i].getId()) {
-        if (specieses[i].shouldMultiplyByCompartmentSizeOnAssignment()) {
-          auto compartments = model->getCompartments();
-          for (auto j = 0; j < compartments.size(); j++) {
-            if (specieses[i].getCompartmentId() == compartments[j].getId()) {
-              auto compartmentIndex = getStateIndexForVariable(compartments[j].getId());
-              dxdt[index] = value * x[compartmentIndex];
-            }
-          }
-        } else {
-          dxdt[index] = value;
-        }
-        continueImmediately = true;
-        break;
+void SBMLSystem::directionalDerivative(const state &x, const state &dx, const double *dp, double t, double dt,
+                                       state &jv) {
+  if (dp == NULL) {
+    std::fill(this->parameterTangents.begin(), this->parameterTangents.end(), 0.0);
+  } else {
+    std::copy(dp, dp + this->parameterTangents.size(), this->parameterTangents.begin());
+  }
+
+  // same sequence as operator(), carrying tangents along
+  for (auto &assignment : this->compiled->rhsAssignmentRuleSequence) {
+    auto value = toAmount(x, dx, assignment.target, evaluateDual(assignment.expressionId, x, dx, t, dt));
+    this->parameters[assignment.target.index] = value.value;
+    this->parameterTangents[assignment.target.index] = value.derivative;
+  }
+
+  auto numReactions = this->compiled->reactionExpressions.size();
+  for (unsigned int i = 0; i < numReactions; i++) {
+    auto rate = evaluateDual(this->compiled->reactionExpressions[i], x, dx, t, dt);
+    this->reactionRates[i] = rate.value;
+    this->reactionRateTangents[i] = rate.derivative;
+  }
+
+  this->stoichiometryMatrix->multiply(this->reactionRateTangents.data(), jv.data().begin());
+  for (auto &entry : this->compiled->variableStoichiometries) {
+    auto stoichiometry = evaluateDual(entry.expressionId, x, dx, t, dt);
+    jv[entry.row] += entry.sign * (this->reactionRateTangents[entry.reaction] * stoichiometry.value
+        + this->reactionRates[entry.reaction] * stoichiometry.derivative);
+  }
+
+  for (unsigned int k = 0; k < this->compiled->rateRuleExpressions.size(); k++) {
+    auto &target = this->compiled->rateRuleTargets[k];
+    auto rate = evaluateDual(this->compiled->rateRuleExpressions[k], x, dx, t, dt);
+    jv[target.index] = toAmount(x, dx, target, rate).derivative;
+  }
+}
+
+SBMLSystemDualJacobi SBMLSystem::createDualJacobi() {
+  auto numStates = this->initialState.size();
+  JacobianColoring coloring(numStates, numStates);
+  bool autonomous = true;
+
+  // states an expression reads, directly or through the assignment rules evaluated in the RHS
+  std::vector<unsigned int> stateIndices;
+  std::vector<unsigned int> parameterIndices;
+  auto collectStates = [&](unsigned int expressionId) {
+    std::vector<bool> rules(this->compiled->assignmentRules.size(), false);
+    requireAssignmentRules(expressionId, rules);
+    this->bytecode->collectLoads(expressionId, stateIndices, parameterIndices);
+    autonomous = autonomous && !this->bytecode->dependsOnTime(expressionId);
+    for (unsigned int i = 0; i < rules.size(); i++) {
+      if (!rules[i]) {
+        continue;
+      }
+      auto &assignment = this->compiled->assignmentRules[i];
+      this->bytecode->collectLoads(assignment.expressionId, stateIndices, parameterIndices);
+      autonomous = autonomous && !this->bytecode->dependsOnTime(assignment.expressionId);
+      if (assignment.target.concentration && !assignment.target.compartmentParameter) {
+        stateIndices.push_back(assignment.target.compartmentIndex);
       }
     }
+  };
 
-    if (continueImmediately) {
-      continue;
+  // reactions
+  auto &columnPointers = this->stoichiometryMatrix->getColumnPointers();
+  auto &rowIndices = this->stoichiometryMatrix->getRowIndices();
+  for (unsigned int i = 0; i < this->compiled->reactionExpressions.size(); i++) {
+    stateIndices.clear();
+    collectStates(this->compiled->reactionExpressions[i]);
+    for (auto k = columnPointers[i]; k < columnPointers[i + 1]; k++) {
+      for (auto column : stateIndices) {
+        coloring.add(rowIndices[k], column);
+      }
     }
+  }
 
-    // compartment or global parameter
-    dxdt[index] = value;
+  // stoichiometryMath
+  for (auto &entry : this->compiled->variableStoichiometries) {
+    stateIndices.clear();
+    collectStates(this->compiled->reactionExpressions[entry.reaction]);
+    collectStates(entry.expressionId);
+    for (auto column : stateIndices) {
+      coloring.add(entry.row, column);
+    }
   }
-}
 
-SBMLSystem::state SBMLSystem::getInitialState() {
-  return this->initialState;
+  // rate rules
+  for (unsigned int k = 0; k < this->compiled->rateRuleExpressions.size(); k++) {
+    auto &target = this->compiled->rateRuleTargets[k];
+    stateIndices.clear();
+    collectStates(this->compiled->rateRuleExpressions[k]);
+    if (target.concentration && !target.compartmentParameter) {
+      stateIndices.push_back(target.compartmentIndex);
+    }
+    for (auto column : stateIndices) {
+      coloring.add(target.index, column);
+    }
+  }
+
+  coloring.color();
+  return SBMLSystemDualJacobi(this, coloring, autonomous);
 }
 
-unsigned int SBMLSystem::getStateIndexForVariable(const std::string &variableId) {
-  return this->stateIndexMap[variableId];
+SBMLSystemBatch SBMLSystem::createBatch(unsigned int numLanes) const {
+  if (getNumEvents() > 0) {
+    RuntimeExceptionUtil::throwIntegrationException("batched systems cannot handle events");
+  }
+  return SBMLSystemBatch(numLanes, this->initialState.size(), this->parameters.size(), this->bytecode,
+                         this->stoichiometryMatrix, this->compiled->reactionExpressions,
+                         this->compiled->variableStoichiometries, this->compiled->rateRuleExpressions,
+                         this->compiled->rateRuleTargets, this->compiled->rhsAssignmentRuleSequence,
+                         this->assignmentRuleSequence);
 }
 
 std::vector<ObserveTarget> SBMLSystem::createOutputTargetsFromOutputFields(
@@ -260,247 +587,479 @@ std::vector<ObserveTarget> SBMLSystem::createOutputTargetsFromOutputFields(
 
   for (auto outputField : outputFields) {
     auto id = outputField.getId();
-    auto stateIndex = getStateIndexForVariable(id);
-    ret.push_back(ObserveTarget(id, stateIndex));
+    auto it = this->compiled->parameterIndexMap.find(id);
+    if (it != this->compiled->parameterIndexMap.end()) {
+      ret.push_back(ObserveTarget(id, it->second, true));
+
+      // observed rule-defined variables have to be kept up to date
+      auto ruleIt = this->compiled->assignmentRuleForParameter.find(it->second);
+      if (ruleIt != this->compiled->assignmentRuleForParameter.end()) {
+        this->assignmentRuleGraph->collectDependencies(ruleIt->second, this->requiredAssignmentRules);
+      }
+    } else {
+      ret.push_back(ObserveTarget(id, getStateIndexForVariable(id), false));
+    }
   }
+  updateAssignmentRuleSequence();
 
   return ret;
 }
 
-double SBMLSystem::evaluateASTNode(const ASTNode *node, const state& x, double t) {
-  double left, right;
+double SBMLSystem::evaluateExpression(unsigned int expressionId, const state &x, double t) {
+  return evaluateExpression(expressionId, x.data().begin(), t);
+}
 
-  // lambda
-  auto evaluateASTNodeLambda = [&](const ASTNode *node) {
-    return evaluateASTNode(node, x, t);
-  };
+double SBMLSystem::evaluateExpression(unsigned int expressionId, const double *x, double t) {
+  return BytecodeInterpreter::evaluate(*this->bytecode, expressionId, x, this->parameters.data(), t,
+                                       this->stack.data());
+}
 
-  // evaluate recursively
-  ASTNodeType_t type = node->getType();
-  switch (type) {
-    case AST_NAME:
-      return evaluateNameNode(node, x, t);
-    case AST_NAME_TIME:
-      return t;
-    case AST_PLUS:
-      left = evaluateASTNodeLambda(node->getLeftChild());
-      right = evaluateASTNodeLambda(node->getRightChild());
-      return left + right;
-    case AST_MINUS:
-      left = evaluateASTNodeLambda(node->getLeftChild());
-      if (node->getNumChildren() == 1) {
-        return - left;
-      } else {
-        right = evaluateASTNodeLambda(node->getRightChild());
-        return left - right;
-      }
-    case AST_TIMES:
-      left = evaluateASTNodeLambda(node->getLeftChild());
-      right = evaluateASTNodeLambda(node->getRightChild());
-      return left * right;
-    case AST_DIVIDE:
-      left = evaluateASTNodeLambda(node->getLeftChild());
-      right = evaluateASTNodeLambda(node->getRightChild());
-      return left / right;
-    case AST_POWER:
-    case AST_FUNCTION_POWER:
-      left = evaluateASTNodeLambda(node->getLeftChild());
-      right = evaluateASTNodeLambda(node->getRightChild());
-      return MathUtil::pow(left, right);
-    case AST_REAL:
-      return node->getReal();
-    case AST_INTEGER:
-      return node->getInteger();
-    case AST_RATIONAL:
-    case AST_REAL_E:
-    case AST_CONSTANT_E:
-      return node->getValue();
-    case AST_FUNCTION_EXP:
-      return MathUtil::exp(evaluateASTNodeLambda(node->getLeftChild()));
-    case AST_FUNCTION_ABS:
-      return MathUtil::fabs(evaluateASTNodeLambda(node->getLeftChild()));
-    case AST_FUNCTION_FACTORIAL:
-      return evaluateFactorialNode(node, x, t);
-    case AST_FUNCTION_CEILING:
-      return MathUtil::ceil(evaluateASTNodeLambda(node->getLeftChild()));
-    case AST_FUNCTION_FLOOR:
-      return MathUtil::floor(evaluateASTNodeLambda(node->getLeftChild()));
-    case AST_FUNCTION_PIECEWISE:
-      return evaluatePiecewiseNode(node, x, t);
-    default:
-      std::cout << "type = " << type << std::endl;
-      break;
-  }
-  return 0;
-}
-
-double SBMLSystem::evaluateNameNode(const ASTNode *node, const state &x, double t) {
-  auto name = node->getName();
+Dual SBMLSystem::evaluateDual(unsigned int expressionId, const state &x, const state &dx, double t, double dt) {
+  return DualInterpreter::evaluate(*this->bytecode, expressionId, x.data().begin(), dx.data().begin(),
+                                   this->parameters.data(), this->parameterTangents.data(), t, dt,
+                                   this->dualStack.data());
+}
+
+void SBMLSystem::setVariableValue(state &x, const std::string &variableId, double value) {
+  auto it = this->compiled->parameterIndexMap.find(variableId);
+  if (it != this->compiled->parameterIndexMap.end()) {
+    this->parameters[it->second] = value;
+  } else {
+    x[getStateIndexForVariable(variableId)] = value;
+  }
+}
+
+void SBMLSystem::compileModel() {
+  this->bytecode = std::make_shared<Bytecode>();
+  auto &bytecode = *this->bytecode;
+
+  // reactions
+  auto &reactions = this->model->getReactions();
+  for (unsigned int i = 0; i < reactions.size(); i++) {
+    this->compiled->reactionExpressions.push_back(BytecodeCompiler::compile(reactions[i].getMath(), bytecode));
+  }
+  buildStoichiometryMatrix();
+
+  // rate rules
+  std::vector<unsigned int> rateRuleTargetSymbols;
+  for (auto rateRule : this->model->getRateRules()) {
+    this->compiled->rateRuleExpressions.push_back(BytecodeCompiler::compile(rateRule->getMath(), bytecode));
+    rateRuleTargetSymbols.push_back(bytecode.addSymbol(rateRule->getVariable()));
+  }
+
+  // assignment rules and initial assignments (targets are bound like symbols)
+  std::vector<std::string> assignmentRuleVariables;
+  std::vector<unsigned int> assignmentRuleTargets;
+  for (auto assignmentRule : this->model->getAssignmentRules()) {
+    Assignment assignment;
+    assignment.expressionId = BytecodeCompiler::compile(assignmentRule->getMath(), bytecode);
+    this->compiled->assignmentRules.push_back(assignment);
+    assignmentRuleVariables.push_back(assignmentRule->getVariable());
+    assignmentRuleTargets.push_back(bytecode.addSymbol(assignmentRule->getVariable()));
+  }
+  std::vector<std::string> initialAssignmentVariables;
+  std::vector<unsigned int> initialAssignmentTargets;
+  for (auto initialAssignment : this->model->getInitialAssignments()) {
+    Assignment assignment;
+    assignment.expressionId = BytecodeCompiler::compile(initialAssignment->getMath(), bytecode);
+    this->compiled->initialAssignmentSequence.push_back(assignment);
+    initialAssignmentVariables.push_back(initialAssignment->getSymbol());
+    initialAssignmentTargets.push_back(bytecode.addSymbol(initialAssignment->getSymbol()));
+  }
+
+  // events
+  for (auto event : this->model->getEvents()) {
+    this->compiled->eventTriggerExpressions.push_back(BytecodeCompiler::compile(event->getTrigger(), bytecode));
+    ASTNode *root = ASTNodeUtil::createRootFunction(event->getTrigger());
+    this->compiled->eventRootExpressions.push_back(BytecodeCompiler::compile(root, bytecode));
+    delete root;
+    std::vector<unsigned int> assignmentExpressions;
+    for (auto &eventAssignment : event->getEventAssignments()) {
+      assignmentExpressions.push_back(BytecodeCompiler::compile(eventAssignment.getMath(), bytecode));
+    }
+    this->compiled->eventAssignmentExpressions.push_back(assignmentExpressions);
+  }
+  // latches start at the triggers' initial values; integrators check the triggers once at the start time
+  this->eventTriggerStates.clear();
+  this->eventAssignmentValues.clear();
+  for (auto event : this->model->getEvents()) {
+    this->eventTriggerStates.push_back(event->getTriggerInitialValue());
+    this->eventAssignmentValues.push_back(std::vector<double>(event->getEventAssignments().size()));
+  }
+  this->pendingEvents.assign(this->eventTriggerStates.size(), false);
+
+  auto bindings = bindSymbols(bytecode);
+  this->stack.resize(bytecode.getMaxStackDepth());
+  this->dualStack.resize(bytecode.getMaxStackDepth());
+  this->parameterTangents.resize(this->parameters.size());
+  this->reactionRateTangents.resize(reactions.size());
+  for (auto symbol : rateRuleTargetSymbols) {
+    this->compiled->rateRuleTargets.push_back(bindings[symbol]);
+  }
+
+  // order rules by dependency
+  for (unsigned int i = 0; i < this->compiled->assignmentRules.size(); i++) {
+    this->compiled->assignmentRules[i].target = bindings[assignmentRuleTargets[i]];
+  }
+  for (unsigned int i = 0; i < this->compiled->initialAssignmentSequence.size(); i++) {
+    this->compiled->initialAssignmentSequence[i].target = bindings[initialAssignmentTargets[i]];
+  }
+  this->compiled->initialAssignmentSequence.insert(this->compiled->initialAssignmentSequence.end(),
+                                                   this->compiled->assignmentRules.begin(),
+                                                   this->compiled->assignmentRules.end());
+  initialAssignmentVariables.insert(initialAssignmentVariables.end(),
+                                    assignmentRuleVariables.begin(), assignmentRuleVariables.end());
+  sortAssignments(this->compiled->assignmentRules, assignmentRuleVariables);
+  sortAssignments(this->compiled->initialAssignmentSequence, initialAssignmentVariables);
+
+  prepareAssignmentRules();
+  this->reactionDependencyGraph = std::make_shared<DependencyGraph>(createReactionDependencyGraph());
+}
+
+std::unordered_map<std::string, const SpeciesWrapper *> SBMLSystem::createSpeciesMap() {
+  std::unordered_map<std::string, const SpeciesWrapper *> speciesMap;
+  for (auto &species : this->model->getSpecieses()) {
+    speciesMap[species.getId()] = &species;
+  }
+  return speciesMap;
+}
+
+SymbolBinding SBMLSystem::createBinding(const std::string &name,
+                                        const std::unordered_map<std::string, const SpeciesWrapper *> &speciesMap) {
+  SymbolBinding binding;
+  binding.concentration = false;
+  binding.compartmentParameter = false;
+  binding.compartmentIndex = 0;
+
+  auto parameterIt = this->compiled->parameterIndexMap.find(name);
+  if (parameterIt != this->compiled->parameterIndexMap.end()) {
+    binding.parameter = true;
+    binding.index = parameterIt->second;
+  } else {
+    auto stateIt = this->compiled->stateIndexMap.find(name);
+    if (stateIt == this->compiled->stateIndexMap.end()) {
+      RuntimeExceptionUtil::throwUnknownNodeNameException(name);
+    }
+    binding.parameter = false;
+    binding.index = stateIt->second;
+  }
 
   // species
-  auto specieses = model->getSpecieses();
-  for (auto i = 0; i < specieses.size(); i++) {
-    if (name == specieses[i].getId()) {
-      if (specieses[i].shouldDivideByCompartmentSizeOnEvaluation()) {
-        auto compartments = model->getCompartments();
-        for (auto j = 0; j < compartments.size(); j++) {
-          if (specieses[i].getCompartmentId() == compartments[j].getId()) {
-            auto speciesIndex = getStateIndexForVariable(specieses[i].getId());
-            auto compartmentIndex = getStateIndexForVariable(compartments[j].getId());
-            return x[speciesIndex] / x[compartmentIndex];
-          }
-        }
-      } else {
-        auto speciesIndex = getStateIndexForVariable(specieses[i].getId());
-        return x[speciesIndex];
-      }
+  auto speciesIt = speciesMap.find(name);
+  if (speciesIt != speciesMap.end() && speciesIt->second->shouldDivideByCompartmentSizeOnEvaluation()) {
+    auto &compartmentId = speciesIt->second->getCompartmentId();
+    auto compartmentIt = this->compiled->parameterIndexMap.find(compartmentId);
+    binding.concentration = true;
+    if (compartmentIt != this->compiled->parameterIndexMap.end()) {
+      binding.compartmentParameter = true;
+      binding.compartmentIndex = compartmentIt->second;
+    } else {
+      binding.compartmentIndex = getStateIndexForVariable(compartmentId);
     }
   }
 
-  // compartment
-  auto compartments = model->getCompartments();
-  for (auto i = 0; i < compartments.size(); i++) {
-    if (name == compartments[i].getId()) {
-      auto index = getStateIndexForVariable(compartments[i].getId());
-      return x[index];
+  return binding;
+}
+
+std::vector<SymbolBinding> SBMLSystem::bindSymbols(Bytecode &bytecode) {
+  auto speciesMap = createSpeciesMap();
+  std::vector<SymbolBinding> bindings;
+  for (unsigned int i = 0; i < bytecode.getNumSymbols(); i++) {
+    bindings.push_back(createBinding(bytecode.getSymbol(i), speciesMap));
+  }
+
+  bytecode.bindSymbols(bindings);
+  return bindings;
+}
+
+DependencyGraph SBMLSystem::createDependencyGraph(const std::vector<Assignment> &assignments) {
+  // state and parameter slots share one key space
+  auto numStates = this->initialState.size();
+  std::unordered_map<unsigned int, unsigned int> assignmentForKey;
+  for (unsigned int i = 0; i < assignments.size(); i++) {
+    auto &target = assignments[i].target;
+    assignmentForKey[target.parameter ? numStates + target.index : target.index] = i;
+  }
+
+  DependencyGraph graph(assignments.size());
+  std::vector<unsigned int> stateIndices;
+  std::vector<unsigned int> parameterIndices;
+  for (unsigned int i = 0; i < assignments.size(); i++) {
+    stateIndices.clear();
+    parameterIndices.clear();
+    this->bytecode->collectLoads(assignments[i].expressionId, stateIndices, parameterIndices);
+    auto &target = assignments[i].target;
+    if (target.concentration) {
+      // the assigned concentration is scaled by the compartment size
+      (target.compartmentParameter ? parameterIndices : stateIndices).push_back(target.compartmentIndex);
+    }
+
+    std::vector<unsigned int> keys(stateIndices.begin(), stateIndices.end());
+    for (auto index : parameterIndices) {
+      keys.push_back(numStates + index);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    for (auto key : keys) {
+      auto it = assignmentForKey.find(key);
+      if (it != assignmentForKey.end()) {
+        graph.addEdge(it->second, i);
+      }
     }
   }
 
-  // global parameter
-  auto parameters = model->getParameters();
-  for (auto i = 0; i < parameters.size(); i++) {
-    if (name == parameters[i]->getId()) {
-      auto index = getStateIndexForVariable(parameters[i]->getId());
-      return x[index];
+  return graph;
+}
+
+void SBMLSystem::sortAssignments(std::vector<Assignment> &assignments, const std::vector<std::string> &variables) {
+  auto graph = createDependencyGraph(assignments);
+  std::vector<unsigned int> order;
+  if (!graph.sortTopologically(order)) {
+    std::vector<bool> sorted(assignments.size(), false);
+    for (auto i : order) {
+      sorted[i] = true;
     }
+    auto cyclic = std::find(sorted.begin(), sorted.end(), false) - sorted.begin();
+    RuntimeExceptionUtil::throwCyclicDependencyException(variables[cyclic]);
   }
 
-  // not reachable
-  RuntimeExceptionUtil::throwUnknownNodeNameException(name);
-  return 0.0;
+  std::vector<Assignment> sortedAssignments;
+  for (auto i : order) {
+    sortedAssignments.push_back(assignments[i]);
+  }
+  assignments.swap(sortedAssignments);
 }
 
-double SBMLSystem::evaluateFactorialNode(const ASTNode *node, const state &x, double t) {
-  const ASTNode *left = node->getLeftChild();
-  long long leftValue;
-  ASTNodeType_t leftType = left->getType();
-  switch (leftType) {
-    case AST_FUNCTION_CEILING:
-      leftValue = MathUtil::ceil(evaluateASTNode(left->getLeftChild(), x, t));
-      return MathUtil::factorial(leftValue);
-    default:
-      break;
+void SBMLSystem::prepareAssignmentRules() {
+  auto numRules = this->compiled->assignmentRules.size();
+  this->assignmentRuleGraph = std::make_shared<DependencyGraph>(createDependencyGraph(this->compiled->assignmentRules));
+  for (unsigned int i = 0; i < numRules; i++) {
+    this->compiled->assignmentRuleForParameter[this->compiled->assignmentRules[i].target.index] = i;
   }
 
-  // not reachable
-  std::cout << "left node type = " << leftType << std::endl;
-  RuntimeExceptionUtil::throwUnknownNodeTypeException(leftType);
-  return 0.0;
+  // rules read by the RHS, and the subset that has to be re-evaluated on every RHS call
+  std::vector<bool> rhsRequired(numRules, false);
+  for (auto expressionId : this->compiled->reactionExpressions) {
+    requireAssignmentRules(expressionId, rhsRequired);
+  }
+  for (auto &entry : this->compiled->variableStoichiometries) {
+    requireAssignmentRules(entry.expressionId, rhsRequired);
+  }
+  for (auto expressionId : this->compiled->rateRuleExpressions) {
+    requireAssignmentRules(expressionId, rhsRequired);
+  }
+  std::vector<bool> dynamic(numRules, false);
+  std::vector<unsigned int> stateIndices;
+  std::vector<unsigned int> parameterIndices;
+  for (unsigned int i = 0; i < numRules; i++) {  // dependency order
+    auto expressionId = this->compiled->assignmentRules[i].expressionId;
+    stateIndices.clear();
+    parameterIndices.clear();
+    this->bytecode->collectLoads(expressionId, stateIndices, parameterIndices);
+    dynamic[i] = !stateIndices.empty() || this->bytecode->dependsOnTime(expressionId);
+    for (auto predecessor : this->assignmentRuleGraph->getPredecessors(i)) {
+      dynamic[i] = dynamic[i] || dynamic[predecessor];
+    }
+    if (rhsRequired[i] && dynamic[i]) {
+      this->compiled->rhsAssignmentRuleSequence.push_back(this->compiled->assignmentRules[i]);
+    }
+  }
+
+  // rules read by events; observed outputs are added by createOutputTargetsFromOutputFields()
+  this->requiredAssignmentRules = rhsRequired;
+  for (auto expressionId : this->compiled->eventTriggerExpressions) {
+    requireAssignmentRules(expressionId, this->requiredAssignmentRules);
+  }
+  for (auto &expressionIds : this->compiled->eventAssignmentExpressions) {
+    for (auto expressionId : expressionIds) {
+      requireAssignmentRules(expressionId, this->requiredAssignmentRules);
+    }
+  }
+  updateAssignmentRuleSequence();
 }
 
-double SBMLSystem::evaluatePiecewiseNode(const ASTNode *node, const state &x, double t) {
-  // piece nodes
-  for (auto i = 0; i < node->getNumChildren() - 1; i += 2) {
-    auto conditionalNode = node->getChild(i + 1);
-    if (evaluateConditionalNode(conditionalNode, x, t)) {
-      return evaluateASTNode(node->getChild(i), x, t);
+void SBMLSystem::requireAssignmentRules(unsigned int expressionId, std::vector<bool> &required) {
+  std::vector<unsigned int> stateIndices;
+  std::vector<unsigned int> parameterIndices;
+  this->bytecode->collectLoads(expressionId, stateIndices, parameterIndices);
+  for (auto index : parameterIndices) {
+    auto it = this->compiled->assignmentRuleForParameter.find(index);
+    if (it != this->compiled->assignmentRuleForParameter.end()) {
+      this->assignmentRuleGraph->collectDependencies(it->second, required);
     }
   }
+}
 
-  // otherwise node
-  auto otherwiseNode = node->getRightChild();
-  return evaluateASTNode(otherwiseNode, x, t);
+void SBMLSystem::updateAssignmentRuleSequence() {
+  this->assignmentRuleSequence.clear();
+  for (unsigned int i = 0; i < this->compiled->assignmentRules.size(); i++) {
+    if (this->requiredAssignmentRules[i]) {
+      this->assignmentRuleSequence.push_back(this->compiled->assignmentRules[i]);
+    }
+  }
 }
 
-bool SBMLSystem::evaluateConditionalNode(const ASTNode *node, const state &x, double t) {
-  double left, right;
-  bool leftCondition, rightCondition;
+double SBMLSystem::toAmount(const state &x, const SymbolBinding &target, double value) {
+  return toAmount(x.data().begin(), target, value);
+}
 
-  // lambda
-  auto evaluateASTNodeLambda = [&](const ASTNode *node) {
-    return evaluateASTNode(node, x, t);
-  };
-  auto evaluateConditionalNodeLambda = [&](const ASTNode *node) {
-    return evaluateConditionalNode(node, x, t);
-  };
+double SBMLSystem::toAmount(const double *x, const SymbolBinding &target, double value) {
+  if (target.concentration) {
+    value *= target.compartmentParameter ? this->parameters[target.compartmentIndex] : x[target.compartmentIndex];
+  }
+  return value;
+}
+
+Dual SBMLSystem::toAmount(const state &x, const state &dx, const SymbolBinding &target, const Dual &value) {
+  if (!target.concentration) {
+    return value;
+  }
+  Dual size;
+  if (target.compartmentParameter) {
+    size.value = this->parameters[target.compartmentIndex];
+    size.derivative = this->parameterTangents[target.compartmentIndex];
+  } else {
+    size.value = x[target.compartmentIndex];
+    size.derivative = dx[target.compartmentIndex];
+  }
+  Dual amount;
+  amount.value = value.value * size.value;
+  amount.derivative = value.derivative * size.value + value.value * size.derivative;
+  return amount;
+}
+
+void SBMLSystem::assign(state &x, const SymbolBinding &target, double value) {
+  value = toAmount(x, target, value);
+  if (target.parameter) {
+    this->parameters[target.index] = value;
+  } else {
+    x[target.index] = value;
+  }
+}
+
+void SBMLSystem::buildStoichiometryMatrix() {
+  auto &reactions = this->model->getReactions();
+  this->stoichiometryMatrix = std::make_shared<StoichiometryMatrix>(this->initialState.size(), reactions.size());
+  this->reactantMatrix = std::make_shared<StoichiometryMatrix>(this->initialState.size(), reactions.size());
+  auto &matrix = *this->stoichiometryMatrix;
 
-  // evaluate recursively
-  auto type = node->getType();
-  switch (type) {
-    case AST_CONSTANT_TRUE:
-      return true;
-    case AST_CONSTANT_FALSE:
-      return false;
-    case AST_RELATIONAL_LT:
-      left = evaluateASTNodeLambda(node->getLeftChild());
-      right = evaluateASTNodeLambda(node->getRightChild());
-      return left < right;
-    case AST_RELATIONAL_LEQ:
-      left = evaluateASTNodeLambda(node->getLeftChild());
-      right = evaluateASTNodeLambda(node->getRightChild());
-      return left <= right;
-    case AST_RELATIONAL_GT:
-      left = evaluateASTNodeLambda(node->getLeftChild());
-      right = evaluateASTNodeLambda(node->getRightChild());
-      return left > right;
-    case AST_RELATIONAL_GEQ:
-      left = evaluateASTNodeLambda(node->getLeftChild());
-      right = evaluateASTNodeLambda(node->getRightChild());
-      return left >= right;
-    case AST_LOGICAL_AND:
-      leftCondition = evaluateConditionalNodeLambda(node->getLeftChild());
-      if (!leftCondition) {
-        return false;
+  // reactions never change boundary or constant species (or those defined by assignment rules),
+  // so their rows are left empty
+  std::unordered_set<std::string> fixedSpecies;
+  for (auto &species : this->model->getSpecieses()) {
+    if (species.hasBoundaryCondition() || species.isConstant()
+        || this->compiled->parameterIndexMap.count(species.getId()) > 0) {
+      fixedSpecies.insert(species.getId());
+    }
+  }
+
+  // entries are appended reaction by reaction, so a pointer per reaction indexes them
+  this->compiled->variableStoichiometryPointers.assign(1, 0);
+  for (unsigned int i = 0; i < reactions.size(); i++) {
+    // reactants
+    for (auto &reactant : reactions[i].getReactants()) {
+      if (fixedSpecies.count(reactant.getSpeciesId()) > 0) {
+        continue;
+      }
+      auto index = getStateIndexForVariable(reactant.getSpeciesId());
+      if (reactant.hasStoichiometryMath()) {
+        VariableStoichiometry entry;
+        entry.reaction = i;
+        entry.row = index;
+        entry.sign = -1.0;
+        entry.expressionId = BytecodeCompiler::compile(reactant.getStoichiometryMath(), *this->bytecode);
+        this->compiled->variableStoichiometries.push_back(entry);
+        this->compiled->variableStoichiometryMaths.push_back(reactant.getStoichiometryMath());
+      } else {
+        matrix.add(index, i, -reactant.getStoichiometry());
+        this->reactantMatrix->add(index, i, reactant.getStoichiometry());
       }
-      rightCondition = evaluateConditionalNodeLambda(node->getRightChild());
-      return rightCondition;
-    case AST_LOGICAL_OR:
-      leftCondition = evaluateConditionalNodeLambda(node->getLeftChild());
-      if (leftCondition) {
-        return true;
+    }
+
+    // products
+    for (auto &product : reactions[i].getProducts()) {
+      if (fixedSpecies.count(product.getSpeciesId()) > 0) {
+        continue;
+      }
+      auto index = getStateIndexForVariable(product.getSpeciesId());
+      if (product.hasStoichiometryMath()) {
+        VariableStoichiometry entry;
+        entry.reaction = i;
+        entry.row = index;
+        entry.sign = 1.0;
+        entry.expressionId = BytecodeCompiler::compile(product.getStoichiometryMath(), *this->bytecode);
+        this->compiled->variableStoichiometries.push_back(entry);
+        this->compiled->variableStoichiometryMaths.push_back(product.getStoichiometryMath());
+      } else {
+        matrix.add(index, i, product.getStoichiometry());
       }
-      rightCondition = evaluateConditionalNodeLambda(node->getRightChild());
-      return rightCondition;
-    case AST_LOGICAL_XOR:
-      leftCondition = evaluateConditionalNodeLambda(node->getLeftChild());
-      rightCondition = evaluateConditionalNodeLambda(node->getRightChild());
-      return leftCondition ^ rightCondition;
-    default:
-      break;
+    }
+    this->compiled->variableStoichiometryPointers.push_back(this->compiled->variableStoichiometries.size());
   }
+  this->stoichiometryChanges.resize(this->compiled->variableStoichiometries.size());
 
-  // not reachable
-  std::cout << "conditional node type = " << type << std::endl;
-  RuntimeExceptionUtil::throwUnknownNodeTypeException(type);
-  return false;
+  matrix.compress();
+  this->reactantMatrix->compress();
+  this->reactionRates.resize(reactions.size());
 }
 
 void SBMLSystem::prepareInitialState() {
+  // only species and rate rule targets change continuously; everything else is kept out of the ODE state
+  std::unordered_set<std::string> rateRuleVariables;
+  for (auto rateRule : this->model->getRateRules()) {
+    rateRuleVariables.insert(rateRule->getVariable());
+  }
+  std::unordered_set<std::string> assignmentRuleVariables;
+  for (auto assignmentRule : this->model->getAssignmentRules()) {
+    assignmentRuleVariables.insert(assignmentRule->getVariable());
+  }
+
+  std::vector<double> is;
+
   auto &specieses = this->model->getSpecieses();
-  auto numSpecies = specieses.size();
+  for (unsigned int i = 0; i < specieses.size(); i++) {
+    auto &id = specieses[i].getId();
+    if (assignmentRuleVariables.count(id) > 0) {
+      this->compiled->parameterIndexMap[id] = this->parameters.size();
+      this->parameters.push_back(specieses[i].getInitialAmountValue());
+    } else {
+      this->compiled->stateIndexMap[id] = is.size();
+      is.push_back(specieses[i].getInitialAmountValue());
+    }
+  }
 
   auto &parameters = this->model->getParameters();
-  auto numGlobalParameters = parameters.size();
+  for (auto i = 0; i < parameters.size(); i++) {
+    auto &id = parameters[i]->getId();
+    if (rateRuleVariables.count(id) > 0) {
+      this->compiled->stateIndexMap[id] = is.size();
+      is.push_back(parameters[i]->getValue());
+    } else {
+      this->compiled->parameterIndexMap[id] = this->parameters.size();
+      this->parameters.push_back(parameters[i]->getValue());
+    }
+  }
 
   auto &compartments = this->model->getCompartments();
-  auto numCompartments = compartments.size();
-
-  auto numVariables = numSpecies + numGlobalParameters + numCompartments;
-  state is(numVariables);
-
-  auto curIndex = 0;
-  for (auto i = 0; i < numSpecies; i++) {
-    this->stateIndexMap[specieses[i].getId()] = curIndex;
-    is[curIndex++] = specieses[i].getInitialAmountValue();
-  }
-  for (auto i = 0; i < parameters.size(); i++) {
-    this->stateIndexMap[parameters[i]->getId()] = curIndex;
-    is[curIndex++] = parameters[i]->getValue();
+  for (unsigned int i = 0; i < compartments.size(); i++) {
+    auto &id = compartments[i].getId();
+    if (rateRuleVariables.count(id) > 0) {
+      this->compiled->stateIndexMap[id] = is.size();
+      is.push_back(compartments[i].getValue());
+    } else {
+      this->compiled->parameterIndexMap[id] = this->parameters.size();
+      this->parameters.push_back(compartments[i].getValue());
+    }
   }
-  for (auto i = 0; i < numCompartments; i++) {
-    this->stateIndexMap[compartments[i].getId()] = curIndex;
-    is[curIndex++] = compartments[i].getValue();
+
+  // reaction-local parameters, under their scoped ids
+  for (auto &reaction : this->model->getReactions()) {
+    for (auto &localParameter : reaction.getLocalParameters()) {
+      this->compiled->parameterIndexMap[localParameter.first] = this->parameters.size();
+      this->parameters.push_back(localParameter.second);
+    }
   }
 
-  this->initialState = is;
+  this->initialState = state(is.size());
+  std::copy(is.begin(), is.end(), this->initialState.begin());
 }
@@ -0,0 +1,142 @@
+#include "sbmlsim/internal/system/SBMLSystemBatch.h"
+#include "sbmlsim/internal/bytecode/BatchInterpreter.h"
+#include "sbmlsim/internal/system/SBMLSystem.h"
+
+SBMLSystemBatch::SBMLSystemBatch(unsigned int numLanes, unsigned int numStates, unsigned int numParameters,
+                                 const std::shared_ptr<Bytecode> &bytecode,
+                                 const std::shared_ptr<StoichiometryMatrix> &stoichiometryMatrix,
+                                 const std::vector<unsigned int> &reactionExpressions,
+                                 const std::vector<VariableStoichiometry> &variableStoichiometries,
+                                 const std::vector<unsigned int> &rateRuleExpressions,
+                                 const std::vector<SymbolBinding> &rateRuleTargets,
+                                 const std::vector<SymbolAssignment> &rhsAssignmentRules,
+                                 const std::vector<SymbolAssignment> &assignmentRules)
+    : numLanes(numLanes), numStates(numStates), bytecode(bytecode), stoichiometryMatrix(stoichiometryMatrix),
+      reactionExpressions(reactionExpressions), variableStoichiometries(variableStoichiometries),
+      rateRuleExpressions(rateRuleExpressions), rateRuleTargets(rateRuleTargets),
+      rhsAssignmentRules(rhsAssignmentRules), assignmentRules(assignmentRules),
+      parameters(numParameters * numLanes), stack(bytecode->getMaxStackDepth() * numLanes),
+      reactionRates(reactionExpressions.size() * numLanes), values(numLanes) {
+  // nothing to do
+}
+
+SBMLSystemBatch::SBMLSystemBatch(const SBMLSystemBatch &batch)
+    : numLanes(batch.numLanes), numStates(batch.numStates), bytecode(batch.bytecode),
+      stoichiometryMatrix(batch.stoichiometryMatrix), reactionExpressions(batch.reactionExpressions),
+      variableStoichiometries(batch.variableStoichiometries), rateRuleExpressions(batch.rateRuleExpressions),
+      rateRuleTargets(batch.rateRuleTargets), rhsAssignmentRules(batch.rhsAssignmentRules),
+      assignmentRules(batch.assignmentRules), parameters(batch.parameters), stack(batch.stack),
+      reactionRates(batch.reactionRates), values(batch.values) {
+  // nothing to do
+}
+
+SBMLSystemBatch::~SBMLSystemBatch() {
+  // nothing to do
+}
+
+void SBMLSystemBatch::operator()(const state &x, state &dxdt, double t) {
+  auto numLanes = this->numLanes;
+  const double *xs = x.data().begin();
+  double *dxs = dxdt.data().begin();
+
+  // assignment rules the RHS depends on
+  for (auto &assignment : this->rhsAssignmentRules) {
+    evaluate(assignment.expressionId, xs, t);
+    toAmount(xs, assignment.target);
+    store(&this->parameters[assignment.target.index * numLanes]);
+  }
+
+  // reaction rates
+  for (unsigned int j = 0; j < this->reactionExpressions.size(); j++) {
+    evaluate(this->reactionExpressions[j], xs, t);
+    store(&this->reactionRates[j * numLanes]);
+  }
+
+  // dxdt = N * v, summed in the order of StoichiometryMatrix::multiply()
+  auto &rowPointers = this->stoichiometryMatrix->getRowPointers();
+  auto &columnIndices = this->stoichiometryMatrix->getColumnIndices();
+  auto &rowValues = this->stoichiometryMatrix->getRowValues();
+  for (unsigned int i = 0; i < this->numStates; i++) {
+    double *dx = dxs + i * numLanes;
+    for (unsigned int l = 0; l < numLanes; l++) {
+      dx[l] = 0.0;
+    }
+    for (auto k = rowPointers[i]; k < rowPointers[i + 1]; k++) {
+      const double *v = &this->reactionRates[columnIndices[k] * numLanes];
+      double coefficient = rowValues[k];
+      for (unsigned int l = 0; l < numLanes; l++) {
+        dx[l] += coefficient * v[l];
+      }
+    }
+  }
+  for (auto &entry : this->variableStoichiometries) {
+    evaluate(entry.expressionId, xs, t);
+    double *dx = dxs + entry.row * numLanes;
+    const double *v = &this->reactionRates[entry.reaction * numLanes];
+    for (unsigned int l = 0; l < numLanes; l++) {
+      dx[l] += entry.sign * v[l] * this->values[l];
+    }
+  }
+
+  // rate rules
+  for (unsigned int k = 0; k < this->rateRuleExpressions.size(); k++) {
+    auto &target = this->rateRuleTargets[k];
+    evaluate(this->rateRuleExpressions[k], xs, t);
+    toAmount(xs, target);
+    store(dxs + target.index * numLanes);
+  }
+}
+
+void SBMLSystemBatch::handleAssignmentRule(state &x, double t) {
+  double *xs = x.data().begin();
+  for (auto &assignment : this->assignmentRules) {
+    evaluate(assignment.expressionId, xs, t);
+    toAmount(xs, assignment.target);
+    auto &target = assignment.target;
+    store(target.parameter ? &this->parameters[target.index * this->numLanes] : xs + target.index * this->numLanes);
+  }
+}
+
+unsigned int SBMLSystemBatch::getNumLanes() const {
+  return this->numLanes;
+}
+
+SBMLSystemBatch::state SBMLSystemBatch::createState() const {
+  return state(this->numStates * this->numLanes, 0.0);
+}
+
+void SBMLSystemBatch::setLane(unsigned int lane, const SBMLSystem &system, const state &x, state &batchState) {
+  auto &parameters = system.getParameterValues();
+  for (unsigned int i = 0; i < parameters.size(); i++) {
+    this->parameters[i * this->numLanes + lane] = parameters[i];
+  }
+  for (unsigned int i = 0; i < this->numStates; i++) {
+    batchState[i * this->numLanes + lane] = x[i];
+  }
+}
+
+double SBMLSystemBatch::getParameterValue(unsigned int lane, unsigned int parameterIndex) const {
+  return this->parameters[parameterIndex * this->numLanes + lane];
+}
+
+void SBMLSystemBatch::evaluate(unsigned int expressionId, const double *x, double t) {
+  BatchInterpreter::evaluate(*this->bytecode, expressionId, x, this->parameters.data(), t, this->numLanes,
+                             this->stack.data(), this->values.data());
+}
+
+void SBMLSystemBatch::toAmount(const double *x, const SymbolBinding &target) {
+  if (!target.concentration) {
+    return;
+  }
+  const double *sizes = target.compartmentParameter ? &this->parameters[target.compartmentIndex * this->numLanes]
+                                                    : x + target.compartmentIndex * this->numLanes;
+  for (unsigned int l = 0; l < this->numLanes; l++) {
+    this->values[l] *= sizes[l];
+  }
+}
+
+void SBMLSystemBatch::store(double *destination) {
+  for (unsigned int l = 0; l < this->numLanes; l++) {
+    destination[l] = this->values[l];
+  }
+}
@@ -0,0 +1,51 @@
+#include "sbmlsim/internal/system/SBMLSystemDualJacobi.h"
+#include "sbmlsim/internal/system/SBMLSystem.h"
+
+SBMLSystemDualJacobi::SBMLSystemDualJacobi(SBMLSystem *system, const JacobianColoring &coloring, bool autonomous)
+    : system(system), coloring(coloring), autonomous(autonomous), columnsByColor(coloring.getNumColors()),
+      seed(coloring.getNumColumns(), 0.0), product(coloring.getNumRows(), 0.0) {
+  auto &colors = this->coloring.getColors();
+  for (unsigned int j = 0; j < colors.size(); j++) {
+    this->columnsByColor[colors[j]].push_back(j);
+  }
+}
+
+SBMLSystemDualJacobi::SBMLSystemDualJacobi(const SBMLSystemDualJacobi &jacobi)
+    : system(jacobi.system), coloring(jacobi.coloring), autonomous(jacobi.autonomous),
+      columnsByColor(jacobi.columnsByColor), seed(jacobi.seed), product(jacobi.product) {
+  // nothing to do
+}
+
+SBMLSystemDualJacobi::~SBMLSystemDualJacobi() {
+  // nothing to do
+}
+
+void SBMLSystemDualJacobi::operator()(const state &x, matrix &J, const double &t, state &dfdt) {
+  auto &columnPointers = this->coloring.getColumnPointers();
+  auto &rowIndices = this->coloring.getRowIndices();
+
+  J.clear();
+  for (auto &columns : this->columnsByColor) {
+    for (auto j : columns) {
+      this->seed[j] = 1.0;
+    }
+    this->system->directionalDerivative(x, this->seed, NULL, t, 0.0, this->product);
+    for (auto j : columns) {
+      this->seed[j] = 0.0;
+      // no other column of this color has a nonzero in these rows
+      for (auto k = columnPointers[j]; k < columnPointers[j + 1]; k++) {
+        J(rowIndices[k], j) = this->product[rowIndices[k]];
+      }
+    }
+  }
+
+  if (this->autonomous) {
+    dfdt.clear();
+  } else {
+    this->system->directionalDerivative(x, this->seed, NULL, t, 1.0, dfdt);
+  }
+}
+
+const JacobianColoring &SBMLSystemDualJacobi::getColoring() const {
+  return this->coloring;
+}
@@ -1,11 +1,58 @@
 #include "sbmlsim/internal/system/SBMLSystemJacobi.h"
+#include "sbmlsim/internal/bytecode/BytecodeInterpreter.h"
+#include "sbmlsim/internal/system/SBMLSystem.h"
+
+SBMLSystemJacobi::SBMLSystemJacobi(const SBMLSystem *system, const std::shared_ptr<Bytecode> &bytecode,
+                                   const std::vector<unsigned int> &partialExpressions,
+                                   const std::vector<JacobianEntry> &entries,
+                                   const std::vector<JacobianEntry> &timeEntries)
+    : system(system), bytecode(bytecode), partialExpressions(partialExpressions),
+      partialValues(partialExpressions.size()), stack(bytecode->getMaxStackDepth()), entries(entries),
+      timeEntries(timeEntries) {
+  // nothing to do
+}
+
+SBMLSystemJacobi::SBMLSystemJacobi(const SBMLSystemJacobi &jacobi)
+    : system(jacobi.system), bytecode(jacobi.bytecode), partialExpressions(jacobi.partialExpressions),
+      partialValues(jacobi.partialValues), stack(jacobi.stack), entries(jacobi.entries),
+      timeEntries(jacobi.timeEntries) {
+  // nothing to do
+}
+
+SBMLSystemJacobi::~SBMLSystemJacobi() {
+  // nothing to do
+}
 
 void SBMLSystemJacobi::operator()(const state &x, matrix &J, const double &t, state &dfdt) {
-  // works with 00001-sbml-l2v4.xml only
-  J(0, 0) = -1.0;
-  J(0, 1) = 0.0;
-  J(1, 0) = 1.0;
-  J(1, 1) = 0.0;
-  dfdt[0] = 0.0;
-  dfdt[1] = 0.0;
+  evaluatePartials(x, t);
+
+  J.clear();
+  for (auto &entry : this->entries) {
+    J(entry.row, entry.column) += entry.coefficient * this->partialValues[entry.partial];
+  }
+
+  dfdt.clear();
+  for (auto &entry : this->timeEntries) {
+    dfdt[entry.row] += entry.coefficient * this->partialValues[entry.partial];
+  }
+}
+
+void SBMLSystemJacobi::evaluatePartials(const state &x, double t) {
+  auto parameters = this->system->getParameterValues().data();
+  for (unsigned int i = 0; i < this->partialExpressions.size(); i++) {
+    this->partialValues[i] = BytecodeInterpreter::evaluate(*this->bytecode, this->partialExpressions[i],
+                                                           x.data().begin(), parameters, t, this->stack.data());
+  }
+}
+
+const std::vector<double> &SBMLSystemJacobi::getPartialValues() const {
+  return this->partialValues;
+}
+
+const std::vector<JacobianEntry> &SBMLSystemJacobi::getEntries() const {
+  return this->entries;
+}
+
+const std::vector<JacobianEntry> &SBMLSystemJacobi::getTimeEntries() const {
+  return this->timeEntries;
 }
@@ -0,0 +1,125 @@
+#include "sbmlsim/internal/system/StoichiometryMatrix.h"
+#include <algorithm>
+
+StoichiometryMatrix::StoichiometryMatrix(unsigned int numRows, unsigned int numColumns)
+    : numRows(numRows), numColumns(numColumns) {
+  // nothing to do
+}
+
+StoichiometryMatrix::StoichiometryMatrix(const StoichiometryMatrix &matrix)
+    : numRows(matrix.numRows), numColumns(matrix.numColumns), entries(matrix.entries),
+      rowPointers(matrix.rowPointers), columnIndices(matrix.columnIndices), rowValues(matrix.rowValues),
+      columnPointers(matrix.columnPointers), rowIndices(matrix.rowIndices), columnValues(matrix.columnValues) {
+  // nothing to do
+}
+
+StoichiometryMatrix::~StoichiometryMatrix() {
+  // nothing to do
+}
+
+void StoichiometryMatrix::add(unsigned int row, unsigned int column, double coefficient) {
+  Entry entry;
+  entry.row = row;
+  entry.column = column;
+  entry.coefficient = coefficient;
+  this->entries.push_back(entry);
+}
+
+void StoichiometryMatrix::compress() {
+  // sort by (row, column) and merge duplicates (e.g. A + A -> B, or A -> A + B)
+  std::sort(this->entries.begin(), this->entries.end(), [](const Entry &a, const Entry &b) {
+    return a.row < b.row || (a.row == b.row && a.column < b.column);
+  });
+  std::vector<Entry> merged;
+  for (auto &entry : this->entries) {
+    if (!merged.empty() && merged.back().row == entry.row && merged.back().column == entry.column) {
+      merged.back().coefficient += entry.coefficient;
+    } else {
+      merged.push_back(entry);
+    }
+  }
+  merged.erase(std::remove_if(merged.begin(), merged.end(), [](const Entry &entry) {
+    return entry.coefficient == 0.0;
+  }), merged.end());
+
+  // CSR
+  this->rowPointers.assign(this->numRows + 1, 0);
+  this->columnIndices.clear();
+  this->rowValues.clear();
+  for (auto &entry : merged) {
+    this->rowPointers[entry.row + 1]++;
+    this->columnIndices.push_back(entry.column);
+    this->rowValues.push_back(entry.coefficient);
+  }
+  for (unsigned int i = 0; i < this->numRows; i++) {
+    this->rowPointers[i + 1] += this->rowPointers[i];
+  }
+
+  // CSC
+  this->columnPointers.assign(this->numColumns + 1, 0);
+  for (auto &entry : merged) {
+    this->columnPointers[entry.column + 1]++;
+  }
+  for (unsigned int j = 0; j < this->numColumns; j++) {
+    this->columnPointers[j + 1] += this->columnPointers[j];
+  }
+  this->rowIndices.resize(merged.size());
+  this->columnValues.resize(merged.size());
+  std::vector<unsigned int> next(this->columnPointers.begin(), this->columnPointers.end() - 1);
+  for (auto &entry : merged) {
+    auto position = next[entry.column]++;
+    this->rowIndices[position] = entry.row;
+    this->columnValues[position] = entry.coefficient;
+  }
+
+  this->entries.clear();
+}
+
+void StoichiometryMatrix::multiply(const double *v, double *y) const {
+  const unsigned int *pointers = this->rowPointers.data();
+  const unsigned int *columns = this->columnIndices.data();
+  const double *values = this->rowValues.data();
+  for (unsigned int i = 0; i < this->numRows; i++) {
+    double sum = 0.0;
+    for (unsigned int k = pointers[i]; k < pointers[i + 1]; k++) {
+      sum += values[k] * v[columns[k]];
+    }
+    y[i] = sum;
+  }
+}
+
+unsigned int StoichiometryMatrix::getNumRows() const {
+  return this->numRows;
+}
+
+unsigned int StoichiometryMatrix::getNumColumns() const {
+  return this->numColumns;
+}
+
+unsigned int StoichiometryMatrix::getNumNonZeros() const {
+  return this->rowValues.size();
+}
+
+const std::vector<unsigned int> &StoichiometryMatrix::getRowPointers() const {
+  return this->rowPointers;
+}
+
+const std::vector<unsigned int> &StoichiometryMatrix::getColumnIndices() const {
+  return this->columnIndices;
+}
+
+const std::vector<double> &StoichiometryMatrix::getRowValues() const {
+  return this->rowValues;
+}
+
+const std::vector<unsigned int> &StoichiometryMatrix::getColumnPointers() const {
+  return this->columnPointers;
+}
+
+const std::vector<unsigned int> &StoichiometryMatrix::getRowIndices() const {
+  return this->rowIndices;
+}
+
+const std::vector<double> &StoichiometryMatrix::getColumnValues() const {
+  return this->columnValues;
+}
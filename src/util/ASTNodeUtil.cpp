@@ -33,7 +33,8 @@ ASTNode *ASTNodeUtil::rewriteFunctionDefinition(const ASTNode *node,
   return ret;
 }
 
-ASTNode *ASTNodeUtil::rewriteLocalParameters(const ASTNode *node, const ListOfParameters *localParameters) {
+ASTNode *ASTNodeUtil::rewriteLocalParameters(const ASTNode *node, const ListOfParameters *localParameters,
+                                             const std::string &scope) {
   ASTNode *ret;
 
   if (node->getType() == AST_NAME) {
@@ -41,8 +42,8 @@ ASTNode *ASTNodeUtil::rewriteLocalParameters(const ASTNode *node, const ListOfPa
     for (auto i = 0; i < localParameters->size(); i++) {
       auto param = localParameters->get(i);
       if (name == param->getId()) {
-        ret = new ASTNode(AST_REAL);
-        ret->setValue(param->getValue());
+        ret = new ASTNode(AST_NAME);
+        ret->setName(createScopedId(scope, param->getId()).c_str());
         return ret;
       }
     }
@@ -54,13 +55,17 @@ ASTNode *ASTNodeUtil::rewriteLocalParameters(const ASTNode *node, const ListOfPa
 
   // replace children's local parameter node recursively
   for (auto i = 0; i < ret->getNumChildren(); i++) {
-    auto newChild = rewriteLocalParameters(ret->getChild(i), localParameters);
+    auto newChild = rewriteLocalParameters(ret->getChild(i), localParameters, scope);
     ret->replaceChild(i, newChild, DELETE_REPLACED_NODE);
   }
 
   return ret;
 }
 
+std::string ASTNodeUtil::createScopedId(const std::string &scope, const std::string &id) {
+  return scope + "." + id;
+}
+
 ASTNode *ASTNodeUtil::reduceToBinary(const ASTNode *node) {
   auto type = node->getType();
   auto numChildren = node->getNumChildren();
@@ -150,3 +155,65 @@ bool ASTNodeUtil::isEqual(const ASTNode *ast1, const ASTNode *ast2) {
   }
   return equal;
 }
+
+ASTNode *ASTNodeUtil::expandNames(const ASTNode *node,
+                                  const std::unordered_map<std::string, const ASTNode *> &definitions) {
+  if (node->getType() == AST_NAME) {
+    auto it = definitions.find(node->getName());
+    if (it != definitions.end()) {
+      return expandNames(it->second, definitions);
+    }
+  }
+
+  ASTNode *ret = node->deepCopy();
+  for (unsigned int i = 0; i < ret->getNumChildren(); i++) {
+    auto newChild = expandNames(ret->getChild(i), definitions);
+    ret->replaceChild(i, newChild, DELETE_REPLACED_NODE);
+  }
+
+  return ret;
+}
+
+ASTNode *ASTNodeUtil::rewriteTimeToName(const ASTNode *node, const std::string &name) {
+  if (node->getType() == AST_NAME_TIME) {
+    ASTNode *ret = new ASTNode(AST_NAME);
+    ret->setName(name.c_str());
+    return ret;
+  }
+
+  ASTNode *ret = node->deepCopy();
+  for (unsigned int i = 0; i < ret->getNumChildren(); i++) {
+    auto newChild = rewriteTimeToName(ret->getChild(i), name);
+    ret->replaceChild(i, newChild, DELETE_REPLACED_NODE);
+  }
+
+  return ret;
+}
+
+void ASTNodeUtil::collectNames(const ASTNode *node, std::set<std::string> &names) {
+  if (node->getType() == AST_NAME) {
+    names.insert(node->getName());
+  }
+  for (unsigned int i = 0; i < node->getNumChildren(); i++) {
+    collectNames(node->getChild(i), names);
+  }
+}
+
+ASTNode *ASTNodeUtil::createRootFunction(const ASTNode *condition) {
+  auto type = condition->getType();
+  ASTNode *root = new ASTNode(AST_MINUS);
+  if (condition->getNumChildren() == 2 && (type == AST_RELATIONAL_GT || type == AST_RELATIONAL_GEQ)) {
+    root->addChild(condition->getChild(0)->deepCopy());
+    root->addChild(condition->getChild(1)->deepCopy());
+  } else if (condition->getNumChildren() == 2 && (type == AST_RELATIONAL_LT || type == AST_RELATIONAL_LEQ)) {
+    root->addChild(condition->getChild(1)->deepCopy());
+    root->addChild(condition->getChild(0)->deepCopy());
+  } else {
+    // any other condition switches between 1 and 0
+    ASTNode *half = new ASTNode(AST_REAL);
+    half->setValue(0.5);
+    root->addChild(condition->deepCopy());
+    root->addChild(half);
+  }
+  return root;
+}
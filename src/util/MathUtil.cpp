@@ -1,6 +1,7 @@
 #include "sbmlsim/internal/util/MathUtil.h"
 #include <cmath>
 #include <sbmlsim/internal/util/ASTNodeUtil.h>
+#include "sbmlsim/internal/util/RuntimeExceptionUtil.h"
 #include <boost/math/common_factor_rt.hpp>
 
 const unsigned long long FACTORIAL_TABLE[] = { // size 20
@@ -171,6 +172,10 @@ ASTNode* MathUtil::differentiate(const ASTNode *ast, std::string target) {
       /* d{u-v}/dx = du/dx - dv/dx */
       differentiatedRoot->setType(AST_MINUS);
       differentiatedRoot->addChild(differentiate(binaryTree->getLeftChild(), target));
+      if (binaryTree->getNumChildren() == 1) {
+        /* d{-u}/dx = -du/dx */
+        break;
+      }
       differentiatedRoot->addChild(differentiate(binaryTree->getRightChild(), target));
       break;
     case AST_TIMES: {
@@ -215,7 +220,9 @@ ASTNode* MathUtil::differentiate(const ASTNode *ast, std::string target) {
     case AST_FUNCTION_POWER:
     case AST_POWER: {
       /* d{u^v}/dx = v * u^(v-1) * du/dx + u^v * ln(u) * dv/dx */
-      differentiatedRoot->setType(AST_PLUS);
+      /* (the second term is dropped for constant v, as ln(u) is undefined for u <= 0) */
+      bool constantExponent = containsTarget(binaryTree->getRightChild(), target) == 0;
+      differentiatedRoot->setType(constantExponent ? AST_TIMES : AST_PLUS);
       // Left multiply
       ASTNode *left = new ASTNode(AST_TIMES);  // v * u^(v-1) * du/dx
       ASTNode *minus = new ASTNode(AST_MINUS); // (v-1)
@@ -230,6 +237,10 @@ ASTNode* MathUtil::differentiate(const ASTNode *ast, std::string target) {
       left->addChild(binaryTree->getRightChild()->deepCopy()); // add v
       left->addChild(power);
       left->addChild(dudx);
+      if (constantExponent) {
+        differentiatedRoot->addChild(left);
+        break;
+      }
       // Right multiply
       ASTNode *right = new ASTNode(AST_TIMES);
       ASTNode *rpower = new ASTNode(AST_POWER);    // u^v
@@ -248,12 +259,20 @@ ASTNode* MathUtil::differentiate(const ASTNode *ast, std::string target) {
     }
     case AST_FUNCTION_ROOT: {
       /* convert root(n, x) to x^(-1 * n) */
+      /* (sqrt(x) may come as root(x)) */
+      bool hasDegree = binaryTree->getNumChildren() == 2;
       ASTNode *power = new ASTNode(AST_POWER);
-      ASTNode *left = binaryTree->getRightChild()->deepCopy();
+      ASTNode *left = (hasDegree ? binaryTree->getRightChild() : binaryTree->getLeftChild())->deepCopy();
       ASTNode *right = new ASTNode(AST_DIVIDE);
       ASTNode *rl = new ASTNode();
       rl->setValue(1);
-      ASTNode *rr = binaryTree->getLeftChild()->deepCopy();
+      ASTNode *rr;
+      if (hasDegree) {
+        rr = binaryTree->getLeftChild()->deepCopy();
+      } else {
+        rr = new ASTNode();
+        rr->setValue(2);
+      }
       right->addChild(rl);
       right->addChild(rr);
       power->addChild(left);
@@ -739,10 +758,20 @@ ASTNode* MathUtil::differentiate(const ASTNode *ast, std::string target) {
     }
     case AST_FUNCTION_LOG: {
       /* d{log_base(u)}/dx = du/dx / (u * ln(base)) */
+      /* (log(u) has base 10) */
       differentiatedRoot->setType(AST_DIVIDE);
-      ASTNode *base = binaryTree->getLeftChild()->deepCopy();
-      ASTNode *dudx = differentiate(binaryTree->getRightChild(), target);
-      ASTNode *u = binaryTree->getRightChild()->deepCopy();
+      ASTNode *base;
+      const ASTNode *argument;
+      if (binaryTree->getNumChildren() == 2) {
+        base = binaryTree->getLeftChild()->deepCopy();
+        argument = binaryTree->getRightChild();
+      } else {
+        base = new ASTNode();
+        base->setValue(10);
+        argument = binaryTree->getLeftChild();
+      }
+      ASTNode *dudx = differentiate(argument, target);
+      ASTNode *u = argument->deepCopy();
       ASTNode *times = new ASTNode(AST_TIMES);
       ASTNode *ln = new ASTNode(AST_FUNCTION_LN);
       ln->addChild(base);
@@ -845,8 +874,7 @@ ASTNode* MathUtil::differentiate(const ASTNode *ast, std::string target) {
       }
       break;
     default:
-      std::cout << binaryTree->getType() << " is unknown" << std::endl;
-      exit(1);
+      RuntimeExceptionUtil::throwUnknownNodeTypeException(binaryTree->getType());
   }
   ASTNode* rtn = ASTNodeUtil::reduceToBinary(differentiatedRoot);
   return rtn;
@@ -901,6 +929,24 @@ ASTNode* MathUtil::simplify(const ASTNode *ast) {
     return simplifiedRoot;
   }
 
+  // unary minus (and plus) has only 1 argument
+  if (binaryTree->isOperator() && binaryTree->getNumChildren() == 1) {
+    left = simplify(binaryTree->getLeftChild());
+    delete binaryTree;
+    if (type == AST_PLUS) {
+      return left;
+    }
+    if (left->isNumber()) {
+      simplifiedRoot = new ASTNode();
+      simplifiedRoot->setValue(-left->getValue());
+      delete left;
+      return simplifiedRoot;
+    }
+    simplifiedRoot = new ASTNode(AST_MINUS);
+    simplifiedRoot->addChild(left);
+    return simplifiedRoot;
+  }
+
   left  = simplify(binaryTree->getLeftChild());
   auto left_val = left->getValue();
 
@@ -20,6 +20,18 @@ void RuntimeExceptionUtil::throwArithmeticException() {
   throwRuntimeException("[RuntimeException] Arithmetic exception");
 }
 
+void RuntimeExceptionUtil::throwCyclicDependencyException(const std::string &variableId) {
+  throwRuntimeException("[RuntimeException] Cyclic dependency: " + variableId);
+}
+
+void RuntimeExceptionUtil::throwIntegrationException(const std::string &message) {
+  throwRuntimeException("[RuntimeException] Integration failed: " + message);
+}
+
+void RuntimeExceptionUtil::throwInvalidArgumentException(const std::string &message) {
+  throwRuntimeException("[RuntimeException] Invalid argument: " + message);
+}
+
 void RuntimeExceptionUtil::throwRuntimeException(const std::string &message) {
   throw std::runtime_error(message);
 }
@@ -2,11 +2,11 @@
 #include "sbmlsim/internal/util/ASTNodeUtil.h"
 
 EventWrapper::EventWrapper(const Event *event) {
-  this->triggerState = false;
-
   this->trigger = ASTNodeUtil::rewriteFunctionDefinition(
       event->getTrigger()->getMath(),
       event->getModel()->getListOfFunctionDefinitions());
+  // level 2 triggers have no initial value and never fire at the start time
+  this->triggerInitialValue = !event->getTrigger()->isSetInitialValue() || event->getTrigger()->getInitialValue();
 
   for (auto i = 0; i < event->getNumEventAssignments(); i++) {
     auto eventAssignment = event->getEventAssignment(i);
@@ -16,6 +16,7 @@ EventWrapper::EventWrapper(const Event *event) {
 
 EventWrapper::EventWrapper(const EventWrapper &event) {
   this->trigger = event.trigger->deepCopy();
+  this->triggerInitialValue = event.triggerInitialValue;
   this->eventAssignments = event.eventAssignments;
 }
 
@@ -28,14 +29,10 @@ const ASTNode *EventWrapper::getTrigger() const {
   return this->trigger;
 }
 
-const std::vector<EventAssignmentWrapper> &EventWrapper::getEventAssignments() const {
-  return this->eventAssignments;
+bool EventWrapper::getTriggerInitialValue() const {
+  return this->triggerInitialValue;
 }
 
-void EventWrapper::setTriggerState(bool triggerState) {
-  this->triggerState = triggerState;
-}
-
-bool EventWrapper::getTriggerState() const {
-  return this->triggerState;
+const std::vector<EventAssignmentWrapper> &EventWrapper::getEventAssignments() const {
+  return this->eventAssignments;
 }
@@ -19,10 +19,11 @@ ModelWrapper::ModelWrapper(const Model *model) {
     this->compartments.push_back(CompartmentWrapper(compartment));
   }
 
-  // reactions
+  // reactions (constructed in place to avoid deep-copying the math of every reaction)
+  this->reactions.reserve(model->getNumReactions());
   for (auto i = 0; i < model->getNumReactions(); i++) {
     auto reaction = model->getReaction(i);
-    this->reactions.push_back(ReactionWrapper(reaction));
+    this->reactions.emplace_back(reaction);
   }
 
   // events
@@ -50,14 +51,24 @@ ModelWrapper::ModelWrapper(const Model *model) {
   }
 }
 
-ModelWrapper::ModelWrapper(const ModelWrapper &model) {
-  this->specieses = model.specieses;
-  this->parameters = model.parameters;
-  this->compartments = model.compartments;
-  this->reactions = model.reactions;
-  this->events = model.events;
-  this->initialAssignments = model.initialAssignments;
-  this->assignmentRules = model.assignmentRules;
+ModelWrapper::ModelWrapper(const ModelWrapper &model)
+    : specieses(model.specieses), compartments(model.compartments), reactions(model.reactions) {
+  // the wrappers held by pointer are owned, so they are copied too
+  for (auto parameter : model.parameters) {
+    this->parameters.push_back(new ParameterWrapper(*parameter));
+  }
+  for (auto event : model.events) {
+    this->events.push_back(new EventWrapper(*event));
+  }
+  for (auto initialAssignment : model.initialAssignments) {
+    this->initialAssignments.push_back(new InitialAssignmentWrapper(*initialAssignment));
+  }
+  for (auto assignmentRule : model.assignmentRules) {
+    this->assignmentRules.push_back(new AssignmentRuleWrapper(*assignmentRule));
+  }
+  for (auto rateRule : model.rateRules) {
+    this->rateRules.push_back(new RateRuleWrapper(*rateRule));
+  }
 }
 
 ModelWrapper::~ModelWrapper() {
@@ -85,13 +96,18 @@ ModelWrapper::~ModelWrapper() {
     delete assignmentRule;
   }
   this->assignmentRules.clear();
+
+  for (auto rateRule : this->rateRules) {
+    delete rateRule;
+  }
+  this->rateRules.clear();
 }
 
 const std::vector<SpeciesWrapper> &ModelWrapper::getSpecieses() const {
   return this->specieses;
 }
 
-std::vector<ParameterWrapper *> &ModelWrapper::getParameters() {
+const std::vector<const ParameterWrapper *> &ModelWrapper::getParameters() const {
   return this->parameters;
 }
 
@@ -103,18 +119,18 @@ const std::vector<ReactionWrapper> &ModelWrapper::getReactions() const {
   return this->reactions;
 }
 
-std::vector<EventWrapper *> &ModelWrapper::getEvents() {
+const std::vector<const EventWrapper *> &ModelWrapper::getEvents() const {
   return this->events;
 }
 
-std::vector<InitialAssignmentWrapper *> &ModelWrapper::getInitialAssignments() {
+const std::vector<const InitialAssignmentWrapper *> &ModelWrapper::getInitialAssignments() const {
   return this->initialAssignments;
 }
 
-std::vector<AssignmentRuleWrapper *> &ModelWrapper::getAssignmentRules() {
+const std::vector<const AssignmentRuleWrapper *> &ModelWrapper::getAssignmentRules() const {
   return this->assignmentRules;
 }
 
-std::vector<RateRuleWrapper *> &ModelWrapper::getRateRules() {
+const std::vector<const RateRuleWrapper *> &ModelWrapper::getRateRules() const {
   return this->rateRules;
 }
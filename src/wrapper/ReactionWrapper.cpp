@@ -14,10 +14,20 @@ ReactionWrapper::ReactionWrapper(const Reaction *reaction) {
 
   auto node = reaction->getKineticLaw()->getMath();
   auto model = reaction->getModel();
+  auto localParameters = reaction->getKineticLaw()->getListOfParameters();
+  for (unsigned int i = 0; i < localParameters->size(); i++) {
+    auto parameter = localParameters->get(i);
+    this->localParameters.push_back(std::make_pair(ASTNodeUtil::createScopedId(this->id, parameter->getId()),
+                                                   parameter->getValue()));
+  }
 
+  // inline function definitions, give local parameters names of their own (so that their values stay
+  // parameters), and reduce to a binary tree once here so that neither the compiler nor MathUtil has to do it again
   auto fdRewritedNode = ASTNodeUtil::rewriteFunctionDefinition(node, model->getListOfFunctionDefinitions());
-  this->math = ASTNodeUtil::rewriteLocalParameters(fdRewritedNode, reaction->getKineticLaw()->getListOfParameters());
+  auto lpRewritedNode = ASTNodeUtil::rewriteLocalParameters(fdRewritedNode, localParameters, this->id);
+  this->math = ASTNodeUtil::reduceToBinary(lpRewritedNode);
   delete fdRewritedNode;
+  delete lpRewritedNode;
 }
 
 ReactionWrapper::ReactionWrapper(const ReactionWrapper &reaction) {
@@ -25,6 +35,7 @@ ReactionWrapper::ReactionWrapper(const ReactionWrapper &reaction) {
   this->reactants = reaction.reactants;
   this->products = reaction.products;
   this->math = reaction.math->deepCopy();
+  this->localParameters = reaction.localParameters;
 }
 
 ReactionWrapper::~ReactionWrapper() {
@@ -45,6 +56,10 @@ const std::vector<SpeciesReferenceWrapper> &ReactionWrapper::getProducts() const
   return this->products;
 }
 
-const ASTNode *ReactionWrapper::getMath() {
+const ASTNode *ReactionWrapper::getMath() const {
   return this->math;
 }
+
+const std::vector<std::pair<std::string, double> > &ReactionWrapper::getLocalParameters() const {
+  return this->localParameters;
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "sbmlsim/SBMLSim.h"
+#include "sbmlsim/internal/bytecode/BytecodeCompiler.h"
+#include "sbmlsim/internal/bytecode/BatchInterpreter.h"
+#include "sbmlsim/internal/bytecode/BytecodeInterpreter.h"
+
+namespace {
+
+class BytecodeCompilerTest : public ::testing::Test {
+ protected:
+  // compiles formula and evaluates it with x = 2, y = 3 (state), z = 6 / 4 (concentration) and k = 5 (parameter)
+  double evaluate(const char *formula, double t = 0.0) {
+    ASTNode *ast = SBML_parseL3Formula(formula);
+    Bytecode bytecode;
+    unsigned int expressionId = BytecodeCompiler::compile(ast, bytecode);
+    delete ast;
+
+    double state[] = {2.0, 3.0, 6.0};
+    double parameters[] = {4.0, 5.0};
+    std::vector<SymbolBinding> bindings;
+    for (unsigned int i = 0; i < bytecode.getNumSymbols(); i++) {
+      auto &name = bytecode.getSymbol(i);
+      SymbolBinding binding;
+      binding.parameter = name == "k";
+      binding.index = name == "x" ? 0 : name == "y" ? 1 : name == "z" ? 2 : 1;
+      binding.concentration = name == "z";
+      binding.compartmentParameter = true;
+      binding.compartmentIndex = 0;
+      bindings.push_back(binding);
+    }
+    bytecode.bindSymbols(bindings);
+
+    std::vector<double> stack(bytecode.getMaxStackDepth());
+    return BytecodeInterpreter::evaluate(bytecode, expressionId, state, parameters, t, stack.data());
+  }
+};
+
+TEST_F(BytecodeCompilerTest, arithmetic) {
+  EXPECT_DOUBLE_EQ(evaluate("x + y * 4"), 14.0);
+  EXPECT_DOUBLE_EQ(evaluate("(x + y) * 4"), 20.0);
+  EXPECT_DOUBLE_EQ(evaluate("x - y - 1"), -2.0);
+  EXPECT_DOUBLE_EQ(evaluate("-x / y"), -2.0 / 3.0);
+  EXPECT_DOUBLE_EQ(evaluate("x^y"), 8.0);
+}
+
+TEST_F(BytecodeCompilerTest, functions) {
+  EXPECT_DOUBLE_EQ(evaluate("exp(x)"), std::exp(2.0));
+  EXPECT_DOUBLE_EQ(evaluate("ln(y)"), std::log(3.0));
+  EXPECT_DOUBLE_EQ(evaluate("sqrt(x)"), std::sqrt(2.0));
+  EXPECT_DOUBLE_EQ(evaluate("abs(x - y)"), 1.0);
+  EXPECT_DOUBLE_EQ(evaluate("floor(y / x)"), 1.0);
+  EXPECT_DOUBLE_EQ(evaluate("factorial(ceil(y / x))"), 2.0);
+}
+
+TEST_F(BytecodeCompilerTest, concentration) {
+  EXPECT_DOUBLE_EQ(evaluate("z"), 1.5);
+  EXPECT_DOUBLE_EQ(evaluate("x * z"), 3.0);
+}
+
+TEST_F(BytecodeCompilerTest, parameter) {
+  EXPECT_DOUBLE_EQ(evaluate("k * x"), 10.0);
+}
+
+TEST_F(BytecodeCompilerTest, time) {
+  EXPECT_DOUBLE_EQ(evaluate("x * time", 1.5), 3.0);
+}
+
+TEST_F(BytecodeCompilerTest, piecewise) {
+  EXPECT_DOUBLE_EQ(evaluate("piecewise(1, x > y, 2, x < y, 3)"), 2.0);
+  EXPECT_DOUBLE_EQ(evaluate("piecewise(1, x > y, 3)"), 3.0);
+  EXPECT_DOUBLE_EQ(evaluate("piecewise(1, x < y, 3)"), 1.0);
+  EXPECT_DOUBLE_EQ(evaluate("1 + piecewise(x, time > 1, y) * 2", 2.0), 5.0);
+  EXPECT_TRUE(std::isnan(evaluate("piecewise(1, x > y)")));
+}
+
+TEST_F(BytecodeCompilerTest, conditions) {
+  EXPECT_DOUBLE_EQ(evaluate("x < y && y < 4"), 1.0);
+  EXPECT_DOUBLE_EQ(evaluate("x > y || y > 4"), 0.0);
+  EXPECT_DOUBLE_EQ(evaluate("x >= 2 && x <= 2"), 1.0);
+}
+
+TEST_F(BytecodeCompilerTest, batch) {
+  // lane l: x = l - 2 (state), k = 0.5 * l (parameter); lanes disagree on the branches
+  const char *formulas[] = {"k * x + exp(-x) / (1 + k)", "piecewise(x, x > 0, k)", "piecewise(1, x < k, 2, k > 1, 3)",
+                            "x^2 * time"};
+  const unsigned int numLanes = 5;
+  Bytecode bytecode;
+  std::vector<unsigned int> expressionIds;
+  for (auto formula : formulas) {
+    ASTNode *ast = SBML_parseL3Formula(formula);
+    expressionIds.push_back(BytecodeCompiler::compile(ast, bytecode));
+    delete ast;
+  }
+  std::vector<SymbolBinding> bindings;
+  for (unsigned int i = 0; i < bytecode.getNumSymbols(); i++) {
+    SymbolBinding binding = {};
+    binding.parameter = bytecode.getSymbol(i) == "k";
+    bindings.push_back(binding);
+  }
+  bytecode.bindSymbols(bindings);
+
+  std::vector<double> x(numLanes), k(numLanes), result(numLanes);
+  for (unsigned int l = 0; l < numLanes; l++) {
+    x[l] = l - 2.0;
+    k[l] = 0.5 * l;
+  }
+  std::vector<double> stack(bytecode.getMaxStackDepth() * numLanes);
+  for (auto expressionId : expressionIds) {
+    BatchInterpreter::evaluate(bytecode, expressionId, x.data(), k.data(), 1.5, numLanes, stack.data(),
+                               result.data());
+    for (unsigned int l = 0; l < numLanes; l++) {
+      EXPECT_DOUBLE_EQ(result[l], BytecodeInterpreter::evaluate(bytecode, expressionId, &x[l], &k[l], 1.5,
+                                                                stack.data()));
+    }
+  }
+}
+
+TEST_F(BytecodeCompilerTest, sharedStorage) {
+  Bytecode bytecode;
+  ASTNode *ast1 = SBML_parseL3Formula("x + 1");
+  ASTNode *ast2 = SBML_parseL3Formula("x * y");
+  auto id1 = BytecodeCompiler::compile(ast1, bytecode);
+  auto id2 = BytecodeCompiler::compile(ast2, bytecode);
+  delete ast1;
+  delete ast2;
+
+  EXPECT_EQ(bytecode.getNumExpressions(), 2);
+  EXPECT_EQ(bytecode.getNumSymbols(), 2);  // x is interned once
+  EXPECT_NE(bytecode.getEntryPoint(id1), bytecode.getEntryPoint(id2));
+}
+
+}  // namespace
@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "sbmlsim/internal/system/DependencyGraph.h"
+
+namespace {
+
+TEST(DependencyGraphTest, sortTopologically) {
+  // 2 -> 0 -> 1, 3 is independent
+  DependencyGraph graph(4);
+  graph.addEdge(2, 0);
+  graph.addEdge(0, 1);
+
+  std::vector<unsigned int> order;
+  ASSERT_TRUE(graph.sortTopologically(order));
+  std::vector<unsigned int> expected = {2, 0, 1, 3};
+  EXPECT_EQ(order, expected);
+}
+
+TEST(DependencyGraphTest, cycle) {
+  // 0 -> 1 -> 2 -> 1
+  DependencyGraph graph(3);
+  graph.addEdge(0, 1);
+  graph.addEdge(1, 2);
+  graph.addEdge(2, 1);
+
+  std::vector<unsigned int> order;
+  EXPECT_FALSE(graph.sortTopologically(order));
+  EXPECT_EQ(order.size(), 1);
+}
+
+}  // namespace
@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "sbmlsim/internal/system/IndexedPriorityQueue.h"
+
+namespace {
+
+TEST(IndexedPriorityQueueTest, build) {
+  IndexedPriorityQueue queue(5);
+  queue.build({3.0, 1.0, 4.0, 1.5, 9.0});
+
+  EXPECT_EQ(queue.getTop(), 1);
+  EXPECT_EQ(queue.getTopKey(), 1.0);
+  EXPECT_EQ(queue.getKey(4), 9.0);
+}
+
+TEST(IndexedPriorityQueueTest, update) {
+  IndexedPriorityQueue queue(5);
+  queue.build({3.0, 1.0, 4.0, 1.5, 9.0});
+
+  queue.update(4, 0.5);  // up
+  EXPECT_EQ(queue.getTop(), 4);
+  queue.update(4, 10.0);  // down
+  EXPECT_EQ(queue.getTop(), 1);
+  queue.update(1, 5.0);
+  EXPECT_EQ(queue.getTop(), 3);
+
+  // items come out in key order
+  std::vector<unsigned int> order;
+  for (auto i = 0; i < 5; i++) {
+    order.push_back(queue.getTop());
+    queue.update(queue.getTop(), 100.0 + i);
+  }
+  EXPECT_EQ(order, std::vector<unsigned int>({3, 0, 2, 1, 4}));
+}
+
+}  // namespace
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "sbmlsim/SBMLSim.h"
+#include "sbmlsim/internal/integrate/IntegrateAuto.h"
+#include "TestModelUtil.h"
+
+namespace {
+
+class IntegrateAutoTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    document = TestModelUtil::createDocument();
+  }
+
+  virtual void TearDown() {
+    delete document;
+  }
+
+  Model *getModel() {
+    return document->getModel();
+  }
+
+  static void ignore(const SBMLSystem::state &x, double t) {
+    // nothing to do
+  }
+
+  SBMLDocument *document;
+};
+
+TEST_F(IntegrateAutoTest, staysExplicit) {
+  TestModelUtil::createSpecies(getModel(), "A", 1.0);
+  TestModelUtil::createSpecies(getModel(), "B", 0.0);
+  TestModelUtil::createReaction(getModel(), "R1", {"A"}, {"B"}, "0.5 * A");
+  ModelWrapper wrapper(getModel());
+  SBMLSystem system(&wrapper);
+  auto x = system.getInitialState();
+  auto statistics = sbmlsim::integrate_auto(system, x, 0.0, 10.0, 1.0, 1e-10, 1e-8, false, ignore);
+
+  EXPECT_FALSE(statistics.stiff);
+  EXPECT_NEAR(x[system.getStateIndexForVariable("A")], std::exp(-5.0), 1e-7);
+}
+
+TEST_F(IntegrateAutoTest, switchesWhenStiff) {
+  // Robertson's problem
+  TestModelUtil::createSpecies(getModel(), "A", 1.0);
+  TestModelUtil::createSpecies(getModel(), "B", 0.0);
+  TestModelUtil::createSpecies(getModel(), "C", 0.0);
+  TestModelUtil::createReaction(getModel(), "R1", {"A"}, {"B"}, "0.04 * A");
+  TestModelUtil::createReaction(getModel(), "R2", {"B", "B"}, {"B", "C"}, "3e7 * B * B");
+  TestModelUtil::createReaction(getModel(), "R3", {"B", "C"}, {"A", "C"}, "1e4 * B * C");
+  ModelWrapper wrapper(getModel());
+  SBMLSystem system(&wrapper);
+  auto x = system.getInitialState();
+  auto statistics = sbmlsim::integrate_auto(system, x, 0.0, 40.0, 4.0, 1e-10, 1e-7, false, ignore);
+
+  EXPECT_TRUE(statistics.stiff);
+  EXPECT_LT(statistics.switchTime, 1.0);
+  EXPECT_NEAR(x[system.getStateIndexForVariable("A")], 0.7158270, 1e-5);
+  EXPECT_NEAR(x[system.getStateIndexForVariable("C")], 0.2841637, 1e-5);
+}
+
+TEST_F(IntegrateAutoTest, restartsAfterEvent) {
+  // A decays and is reset to 1 at t = 2; the next dopri5 step must not reuse dA/dt from before the reset
+  TestModelUtil::createSpecies(getModel(), "A", 1.0);
+  TestModelUtil::createReaction(getModel(), "R1", {"A"}, {}, "0.5 * A");
+  TestModelUtil::createEvent(getModel(), "reset", "time > 1.5", {{"A", "1"}});
+  ModelWrapper wrapper(getModel());
+
+  for (auto stiff : {false, true}) {
+    SBMLSystem system(&wrapper);
+    auto x = system.getInitialState();
+    sbmlsim::integrate_auto(system, x, 0.0, 3.0, 1.0, 1e-10, 1e-8, stiff, ignore);
+    EXPECT_NEAR(x[system.getStateIndexForVariable("A")], std::exp(-0.5), 1e-7);
+  }
+}
+
+}  // namespace
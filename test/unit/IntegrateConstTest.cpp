@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "sbmlsim/SBMLSim.h"
+#include "sbmlsim/internal/integrate/IntegrateConst.h"
+#include "TestModelUtil.h"
+
+namespace {
+
+class IntegrateConstTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    // A -> (0.5 * A), A(0) = 1
+    document = TestModelUtil::createDocument();
+    Model *model = document->getModel();
+    TestModelUtil::createSpecies(model, "A", 1.0);
+    TestModelUtil::createReaction(model, "R1", {"A"}, {}, "0.5 * A");
+
+    modelWrapper = new ModelWrapper(model);
+  }
+
+  virtual void TearDown() {
+    delete modelWrapper;
+    delete document;
+  }
+
+  static void ignore(const SBMLSystem::state &x, double t) {
+    // nothing to do
+  }
+
+  SBMLDocument *document;
+  ModelWrapper *modelWrapper;
+};
+
+TEST_F(IntegrateConstTest, denseOutput) {
+  SBMLSystem system(modelWrapper);
+  auto x = system.getInitialState();
+  auto stepper = odeint::make_dense_output<odeint::runge_kutta_dopri5<SBMLSystem::state> >(1e-10, 1e-10);
+  sbmlsim::integrate_const(stepper, system, x, 0.0, 4.0, 0.01, ignore);
+
+  EXPECT_NEAR(x[0], std::exp(-2.0), 1e-8);
+}
+
+TEST_F(IntegrateConstTest, denseOutputKeepsStepSize) {
+  // a fine output grid does not cut the step sequence
+  SBMLSystem controlledSystem(modelWrapper);
+  auto x = controlledSystem.getInitialState();
+  auto controlled = odeint::make_controlled<odeint::runge_kutta_dopri5<SBMLSystem::state> >(1e-8, 1e-8);
+  auto controlledSteps = sbmlsim::integrate_const(controlled, controlledSystem, x, 0.0, 4.0, 0.001, ignore);
+
+  SBMLSystem denseSystem(modelWrapper);
+  auto y = denseSystem.getInitialState();
+  auto dense = odeint::make_dense_output<odeint::runge_kutta_dopri5<SBMLSystem::state> >(1e-8, 1e-8);
+  auto denseSteps = sbmlsim::integrate_const(dense, denseSystem, y, 0.0, 4.0, 0.001, ignore);
+
+  EXPECT_EQ(controlledSteps, 4000);
+  EXPECT_LT(denseSteps * 10, controlledSteps);
+  EXPECT_NEAR(x[0], y[0], 1e-7);
+}
+
+TEST_F(IntegrateConstTest, eventLocation) {
+  // A is reset to 10 when it falls below 5, at t = 2 ln 2 (between output points)
+  TestModelUtil::createEvent(document->getModel(), "E1", "A < 5", {{"A", "10"}});
+  ModelWrapper wrapper(document->getModel());
+  SBMLSystem system(&wrapper);
+  auto x = system.getInitialState();
+  auto stepper = odeint::make_dense_output<odeint::runge_kutta_dopri5<SBMLSystem::state> >(1e-10, 1e-10);
+  sbmlsim::integrate_const(stepper, system, x, 0.0, 2.0, 1.0, ignore);
+
+  EXPECT_NEAR(x[0], 10.0 * std::exp(-0.5 * (2.0 - 2.0 * std::log(2.0))), 1e-7);
+}
+
+}  // namespace
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "sbmlsim/SBMLSim.h"
+#include "sbmlsim/Simulator.h"
+#include "sbmlsim/internal/integrate/IntegrateLSODA.h"
+#include "TestModelUtil.h"
+
+namespace {
+
+class IntegrateLSODATest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    // A -> (0.5 * A), A(0) = 1
+    document = TestModelUtil::createDocument();
+    TestModelUtil::createSpecies(getModel(), "A", 1.0);
+    TestModelUtil::createReaction(getModel(), "R1", {"A"}, {}, "0.5 * A");
+  }
+
+  virtual void TearDown() {
+    delete document;
+  }
+
+  Model *getModel() {
+    return document->getModel();
+  }
+
+  static void ignore(const SBMLSystem::state &x, double t) {
+    // nothing to do
+  }
+
+  SBMLDocument *document;
+};
+
+TEST_F(IntegrateLSODATest, decay) {
+  ModelWrapper wrapper(getModel());
+  SBMLSystem system(&wrapper);
+  auto x = system.getInitialState();
+  std::vector<double> rtol(x.size(), 1e-10);
+  std::vector<double> atol(x.size(), 1e-12);
+  std::vector<double> times;
+  auto statistics = sbmlsim::integrate_lsoda(system, x, 0.0, 10.0, 1.0, rtol, atol,
+                                             [&times](const SBMLSystem::state &x, double t) {
+    EXPECT_NEAR(x[0], std::exp(-0.5 * t), 1e-8);
+    times.push_back(t);
+  });
+
+  EXPECT_GT(statistics.state, 0);
+  EXPECT_TRUE(statistics.error.empty());
+  EXPECT_EQ(statistics.numOutputPoints, 11);
+  EXPECT_GT(statistics.numFunctionEvaluations, 0);
+  EXPECT_EQ(statistics.numRestarts, 0);
+  ASSERT_EQ(times.size(), 11);
+  EXPECT_EQ(times.back(), 10.0);
+}
+
+TEST_F(IntegrateLSODATest, restartsAfterEvent) {
+  // A is reset to 1 at the output point t = 2; LSODA must not continue from its history before the reset
+  TestModelUtil::createEvent(getModel(), "reset", "time > 1.5", {{"A", "1"}});
+  ModelWrapper wrapper(getModel());
+  SBMLSystem system(&wrapper);
+  auto x = system.getInitialState();
+  std::vector<double> rtol(x.size(), 1e-10);
+  std::vector<double> atol(x.size(), 1e-12);
+  auto statistics = sbmlsim::integrate_lsoda(system, x, 0.0, 4.0, 1.0, rtol, atol, ignore);
+
+  EXPECT_GT(statistics.state, 0);
+  EXPECT_EQ(statistics.numRestarts, 1);
+  EXPECT_NEAR(x[0], std::exp(-1.0), 1e-8);
+}
+
+TEST_F(IntegrateLSODATest, failure) {
+  // with 0 -> A at A * A + 0.5 * A, dA/dt = A * A blows up at t = 1
+  TestModelUtil::createReaction(getModel(), "R2", {}, {"A"}, "A * A + 0.5 * A");
+  ModelWrapper wrapper(getModel());
+  SBMLSystem system(&wrapper);
+  auto x = system.getInitialState();
+  std::vector<double> rtol(x.size(), 1e-10);
+  std::vector<double> atol(x.size(), 1e-12);
+  auto statistics = sbmlsim::integrate_lsoda(system, x, 0.0, 2.0, 0.5, rtol, atol, ignore);
+
+  EXPECT_LE(statistics.state, 0);
+  EXPECT_FALSE(statistics.error.empty());
+  // the run stops at the failure, without the remaining output points
+  EXPECT_GE(statistics.numOutputPoints, 2);
+  EXPECT_LT(statistics.numOutputPoints, 5);
+
+  // the simulator reports the failure as an exception
+  Simulator simulator(document);
+  RunConfiguration conf(2.0, 0.5, {OutputField("A", OutputType::AMOUNT)});
+  conf.setIntegrator(IntegratorType::LSODA);
+  EXPECT_THROW(simulator.run(conf, {}, [](double t, const std::vector<double> &output) {}), std::exception);
+}
+
+}  // namespace
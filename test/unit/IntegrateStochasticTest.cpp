@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include <random>
+#include "sbmlsim/SBMLSim.h"
+#include "sbmlsim/internal/integrate/IntegrateCompositionRejection.h"
+#include "sbmlsim/internal/integrate/IntegrateDirect.h"
+#include "sbmlsim/internal/integrate/IntegrateEnsemble.h"
+#include "sbmlsim/internal/integrate/IntegrateNextReaction.h"
+#include "sbmlsim/internal/integrate/IntegrateTauLeaping.h"
+#include "sbmlsim/internal/observer/EnsembleStatisticsObserver.h"
+#include "TestModelUtil.h"
+
+namespace {
+
+class IntegrateStochasticTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    // birth-death: 0 -> A (10), A -> 0 (A); A is Poisson distributed with mean 10 at steady state
+    document = TestModelUtil::createDocument();
+    Model *model = document->getModel();
+    TestModelUtil::createSpecies(model, "A", 0.0);
+    TestModelUtil::createReaction(model, "birth", {}, {"A"}, "10");
+    TestModelUtil::createReaction(model, "death", {"A"}, {}, "A");
+
+    modelWrapper = new ModelWrapper(model);
+  }
+
+  virtual void TearDown() {
+    delete modelWrapper;
+    delete document;
+  }
+
+  SBMLDocument *document;
+  ModelWrapper *modelWrapper;
+};
+
+TEST_F(IntegrateStochasticTest, directMethod) {
+  SBMLSystem system(modelWrapper);
+  auto x = system.getInitialState();
+  std::mt19937_64 random(1);
+  double sum = 0.0, sumOfSquares = 0.0;
+  unsigned long count = 0;
+  auto statistics = sbmlsim::integrate_direct(
+      system, x, 0.0, 2000.0, 0.5, random, [&](const SBMLSystem::state &x, double t) {
+        EXPECT_EQ(x[0], std::floor(x[0]));
+        if (t >= 20.0) {
+          sum += x[0];
+          sumOfSquares += x[0] * x[0];
+          count++;
+        }
+      });
+
+  double mean = sum / count;
+  EXPECT_EQ(statistics.numOutputPoints, 4001);
+  EXPECT_NEAR(mean, 10.0, 0.3);
+  EXPECT_NEAR(sumOfSquares / count - mean * mean, 10.0, 1.0);
+}
+
+TEST_F(IntegrateStochasticTest, sameSeedSameTrajectory) {
+  std::vector<double> first, second;
+  for (auto samples : {&first, &second}) {
+    SBMLSystem system(modelWrapper);
+    auto x = system.getInitialState();
+    std::mt19937_64 random(42);
+    sbmlsim::integrate_direct(system, x, 0.0, 10.0, 0.1, random, [&](const SBMLSystem::state &x, double t) {
+      samples->push_back(x[0]);
+    });
+  }
+
+  EXPECT_EQ(first, second);
+}
+
+TEST_F(IntegrateStochasticTest, reactionDependencyGraph) {
+  SBMLSystem system(modelWrapper);
+  auto &graph = system.getReactionDependencyGraph();
+
+  // birth changes A, which death reads; nothing changes what birth reads
+  EXPECT_EQ(graph.getSuccessors(0), std::vector<unsigned int>({1}));
+  EXPECT_EQ(graph.getSuccessors(1), std::vector<unsigned int>({1}));
+}
+
+TEST_F(IntegrateStochasticTest, fireReactionWithStoichiometryMath) {
+  // birth also makes 2 * A + 1 of B
+  Model *model = document->getModel();
+  TestModelUtil::createSpecies(model, "B", 0.0);
+  SpeciesReference *product = model->getReaction(0)->createProduct();
+  product->setSpecies("B");
+  TestModelUtil::setMath(product->createStoichiometryMath(), "2 * A + 1");
+  ModelWrapper wrapper(model);
+  SBMLSystem system(&wrapper);
+  auto a = system.getStateIndexForVariable("A");
+  auto bIndex = system.getStateIndexForVariable("B");
+
+  EXPECT_TRUE(system.hasVariableStoichiometry(0));
+  EXPECT_FALSE(system.hasVariableStoichiometry(1));
+  auto x = system.getInitialState();
+  x[a] = 3.0;
+  // stoichiometryMath is evaluated before the reaction changes A
+  system.fireReaction(0, x, 0.0, 2.0);
+  EXPECT_EQ(x[a], 5.0);
+  EXPECT_EQ(x[bIndex], 14.0);
+  system.fireReaction(1, x, 0.0);
+  EXPECT_EQ(x[a], 4.0);
+  EXPECT_EQ(x[bIndex], 14.0);
+}
+
+TEST_F(IntegrateStochasticTest, nextReactionMethod) {
+  SBMLSystem system(modelWrapper);
+  auto x = system.getInitialState();
+  std::mt19937_64 random(1);
+  double sum = 0.0, sumOfSquares = 0.0;
+  unsigned long count = 0;
+  auto statistics = sbmlsim::integrate_next_reaction(
+      system, x, 0.0, 2000.0, 0.5, random, [&](const SBMLSystem::state &x, double t) {
+        if (t >= 20.0) {
+          sum += x[0];
+          sumOfSquares += x[0] * x[0];
+          count++;
+        }
+      });
+
+  double mean = sum / count;
+  EXPECT_EQ(statistics.numOutputPoints, 4001);
+  EXPECT_NEAR(mean, 10.0, 0.3);
+  EXPECT_NEAR(sumOfSquares / count - mean * mean, 10.0, 1.0);
+}
+
+TEST_F(IntegrateStochasticTest, compositionRejection) {
+  SBMLSystem system(modelWrapper);
+  auto x = system.getInitialState();
+  std::mt19937_64 random(1);
+  double sum = 0.0, sumOfSquares = 0.0;
+  unsigned long count = 0;
+  auto statistics = sbmlsim::integrate_composition_rejection(
+      system, x, 0.0, 2000.0, 0.5, random, [&](const SBMLSystem::state &x, double t) {
+        if (t >= 20.0) {
+          sum += x[0];
+          sumOfSquares += x[0] * x[0];
+          count++;
+        }
+      });
+
+  double mean = sum / count;
+  EXPECT_EQ(statistics.numOutputPoints, 4001);
+  EXPECT_NEAR(mean, 10.0, 0.3);
+  EXPECT_NEAR(sumOfSquares / count - mean * mean, 10.0, 1.0);
+}
+
+TEST_F(IntegrateStochasticTest, tauLeaping) {
+  // from 1000 molecules the mean decays as 10 + 990 exp(-t); leaps take many firings at once
+  SBMLSystem system(modelWrapper);
+  auto x = system.getInitialState();
+  x[0] = 1000.0;
+  std::mt19937_64 random(1);
+  auto statistics = sbmlsim::integrate_tau_leaping(
+      system, x, 0.0, 1.0, 0.1, TAU_LEAPING_EPSILON, random, [&](const SBMLSystem::state &x, double t) {
+        EXPECT_GE(x[0], 0.0);
+      });
+
+  EXPECT_EQ(statistics.numOutputPoints, 11);
+  EXPECT_GT(statistics.numLeaps, 0);
+  EXPECT_GT(statistics.numFirings, 5 * (statistics.numLeaps + statistics.numExactSteps));
+  EXPECT_NEAR(x[0], 10.0 + 990.0 * std::exp(-1.0), 60.0);
+}
+
+TEST_F(IntegrateStochasticTest, ensembleIndependentOfThreadCount) {
+  // every worker writes its own slots, so the observer needs no lock
+  const unsigned long numTrajectories = 16;
+  SBMLSystem system(modelWrapper);
+  std::vector<std::vector<double> > serial(numTrajectories), parallel(numTrajectories);
+  auto statistics = sbmlsim::integrate_ensemble(
+      system, IntegratorType::GILLESPIE_NEXT_REACTION, 0.0, 5.0, 0.5, numTrajectories, 7, 1,
+      [&](unsigned int worker, unsigned long trajectory, const SBMLSystem &trajectorySystem,
+          const SBMLSystem::state &x, double t) {
+        serial[trajectory].push_back(x[0]);
+      });
+  EXPECT_EQ(statistics.numThreads, 1);
+  statistics = sbmlsim::integrate_ensemble(
+      system, IntegratorType::GILLESPIE_NEXT_REACTION, 0.0, 5.0, 0.5, numTrajectories, 7, 4,
+      [&](unsigned int worker, unsigned long trajectory, const SBMLSystem &trajectorySystem,
+          const SBMLSystem::state &x, double t) {
+        EXPECT_LT(worker, 4);
+        parallel[trajectory].push_back(x[0]);
+      });
+  EXPECT_EQ(statistics.numThreads, 4);
+  EXPECT_EQ(statistics.numTrajectories, numTrajectories);
+
+  for (unsigned int i = 0; i < numTrajectories; i++) {
+    EXPECT_EQ(serial[i].size(), 11);
+    EXPECT_EQ(serial[i], parallel[i]);
+  }
+  EXPECT_NE(serial[0], serial[1]);
+}
+
+TEST_F(IntegrateStochasticTest, ensembleStatistics) {
+  // starting from 0, A(t) is Poisson distributed with mean 10 (1 - exp(-t))
+  SBMLSystem system(modelWrapper);
+  EnsembleStatisticsObserver observer(std::vector<ObserveTarget>{ObserveTarget("A", 0)}, 4);
+  sbmlsim::integrate_ensemble(system, IntegratorType::GILLESPIE_DIRECT, 0.0, 5.0, 1.0, 4000, 3, 4,
+                              std::ref(observer));
+  observer.merge();
+
+  EXPECT_EQ(observer.getNumTimePoints(), 6);
+  for (auto i = 0; i < 6; i++) {
+    double mean = 10.0 * (1.0 - std::exp(-observer.getTime(i)));
+    auto &statistics = observer.getStatistics(i, 0);
+    EXPECT_EQ(statistics.getCount(), 4000);
+    EXPECT_NEAR(statistics.getMean(), mean, 0.2);
+    EXPECT_NEAR(statistics.getVariance(), mean, 0.1 * mean + 0.01);
+  }
+  EXPECT_EQ(observer.getQuantiles(0, 0).getQuantile(0.5), 0.0);
+  EXPECT_NEAR(observer.getQuantiles(5, 0).getQuantile(0.5), 10.0, 1.0);
+}
+
+}  // namespace
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include "sbmlsim/internal/system/JacobianColoring.h"
+
+namespace {
+
+TEST(JacobianColoringTest, diagonal) {
+  JacobianColoring coloring(4, 4);
+  for (auto i = 0; i < 4; i++) {
+    coloring.add(i, i);
+  }
+  coloring.color();
+
+  EXPECT_EQ(coloring.getNumColors(), 1);
+}
+
+TEST(JacobianColoringTest, tridiagonal) {
+  // columns sharing a row get different colors
+  unsigned int n = 6;
+  JacobianColoring coloring(n, n);
+  for (unsigned int i = 0; i < n; i++) {
+    for (unsigned int j = (i == 0 ? 0 : i - 1); j <= i + 1 && j < n; j++) {
+      coloring.add(i, j);
+      coloring.add(i, j);  // duplicates are merged
+    }
+  }
+  coloring.color();
+
+  EXPECT_EQ(coloring.getNumColors(), 3);
+  EXPECT_EQ(coloring.getRowIndices().size(), 3 * n - 2);
+  auto &colors = coloring.getColors();
+  for (unsigned int j = 0; j + 2 < n; j++) {
+    EXPECT_NE(colors[j], colors[j + 1]);
+    EXPECT_NE(colors[j], colors[j + 2]);
+  }
+}
+
+}  // namespace
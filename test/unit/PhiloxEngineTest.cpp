@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "sbmlsim/internal/random/PhiloxEngine.h"
+
+namespace {
+
+TEST(PhiloxEngineTest, knownAnswers) {
+  // Random123 known-answer tests for philox4x32-10
+  std::uint32_t output[4];
+  const std::uint32_t zeroCounter[4] = {0, 0, 0, 0};
+  const std::uint32_t zeroKey[2] = {0, 0};
+  PhiloxEngine::generate(zeroCounter, zeroKey, output);
+  EXPECT_EQ(output[0], 0x6627e8d5u);
+  EXPECT_EQ(output[1], 0xe169c58du);
+  EXPECT_EQ(output[2], 0xbc57ac4cu);
+  EXPECT_EQ(output[3], 0x9b00dbd8u);
+
+  const std::uint32_t onesCounter[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+  const std::uint32_t onesKey[2] = {0xffffffff, 0xffffffff};
+  PhiloxEngine::generate(onesCounter, onesKey, output);
+  EXPECT_EQ(output[0], 0x408f276du);
+  EXPECT_EQ(output[1], 0x41c83b0eu);
+  EXPECT_EQ(output[2], 0xa20bc7c6u);
+  EXPECT_EQ(output[3], 0x6d5451fdu);
+}
+
+TEST(PhiloxEngineTest, streams) {
+  PhiloxEngine first(42, 7);
+  PhiloxEngine second(42, 7);
+  PhiloxEngine other(42, 8);
+  for (auto i = 0; i < 10; i++) {
+    auto value = first();
+    EXPECT_EQ(value, second());
+    EXPECT_NE(value, other());
+  }
+}
+
+}  // namespace
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "sbmlsim/internal/system/PropensityGroups.h"
+
+namespace {
+
+TEST(PropensityGroupsTest, update) {
+  PropensityGroups groups(3);
+  groups.update(0, 1.0);
+  groups.update(1, 1000.0);
+  groups.update(2, 0.001);
+  EXPECT_DOUBLE_EQ(groups.getTotal(), 1001.001);
+
+  groups.update(1, 3.0);  // moves to another group
+  groups.update(2, 0.0);  // cannot fire
+  EXPECT_DOUBLE_EQ(groups.getTotal(), 4.0);
+  EXPECT_EQ(groups.getPropensity(2), 0.0);
+}
+
+TEST(PropensityGroupsTest, select) {
+  // propensities spread over six orders of magnitude are selected in proportion
+  std::vector<double> propensities = {1e-3, 0.5, 0.7, 2.0, 300.0};
+  PropensityGroups groups(propensities.size());
+  double total = 0.0;
+  for (unsigned int i = 0; i < propensities.size(); i++) {
+    groups.update(i, propensities[i]);
+    total += propensities[i];
+  }
+
+  std::mt19937_64 random(1);
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+  auto uniform = [&]() { return distribution(random); };
+  std::vector<double> counts(propensities.size(), 0.0);
+  unsigned int n = 1000000;
+  for (unsigned int k = 0; k < n; k++) {
+    counts[groups.select(uniform)] += 1.0;
+  }
+  for (unsigned int i = 0; i < propensities.size(); i++) {
+    double p = propensities[i] / total;
+    EXPECT_NEAR(counts[i] / n, p, 5.0 * std::sqrt(p * (1.0 - p) / n));
+  }
+}
+
+}  // namespace
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include "sbmlsim/internal/statistics/QuantileSketch.h"
+
+namespace {
+
+TEST(QuantileSketchTest, exactWhileSmall) {
+  QuantileSketch sketch(100);
+  EXPECT_TRUE(std::isnan(sketch.getQuantile(0.5)));
+  for (auto i = 100; i > 0; i--) {
+    sketch.add(i);
+  }
+  EXPECT_EQ(sketch.getQuantile(0.0), 1.0);
+  EXPECT_EQ(sketch.getQuantile(0.5), 50.0);
+  EXPECT_EQ(sketch.getQuantile(0.95), 95.0);
+  EXPECT_EQ(sketch.getQuantile(1.0), 100.0);
+}
+
+TEST(QuantileSketchTest, mergedStreams) {
+  // 0 .. n-1 in a scrambled order, split over two sketches
+  const unsigned long n = 100000;
+  QuantileSketch first, second;
+  for (unsigned long i = 0; i < n; i++) {
+    double value = static_cast<double>((i * 7919) % n);
+    (i % 3 == 0 ? first : second).add(value);
+  }
+  first.merge(second);
+  EXPECT_EQ(first.getCount(), n);
+  for (auto probability : {0.05, 0.25, 0.5, 0.75, 0.95}) {
+    EXPECT_NEAR(first.getQuantile(probability), probability * n, 0.01 * n);
+  }
+}
+
+TEST(QuantileSketchTest, boundedSize) {
+  const unsigned long n = 1000000;
+  QuantileSketch sketch, merged;
+  unsigned long largest = 0;
+  for (unsigned long i = 0; i < n; i++) {
+    sketch.add(static_cast<double>((i * 7919) % n));
+    largest = std::max(largest, sketch.getSize());
+    if (i % 1000 == 999) {
+      merged.merge(sketch);
+      largest = std::max(largest, merged.getSize());
+      sketch = QuantileSketch();
+    }
+  }
+  EXPECT_EQ(merged.getCount(), n);
+  // 3 * capacity plus 2 per level, whatever n is
+  EXPECT_LT(largest, 3 * QUANTILE_SKETCH_CAPACITY + 2 * 20);
+  EXPECT_NEAR(merged.getQuantile(0.5), 0.5 * n, 0.01 * n);
+}
+
+}  // namespace
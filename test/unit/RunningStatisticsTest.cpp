@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+#include "sbmlsim/internal/statistics/RunningStatistics.h"
+
+namespace {
+
+TEST(RunningStatisticsTest, addAndMerge) {
+  const double values[] = {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0};
+  RunningStatistics all, first, second;
+  for (auto i = 0; i < 8; i++) {
+    all.add(values[i]);
+    (i < 3 ? first : second).add(values[i]);
+  }
+  EXPECT_EQ(all.getCount(), 8);
+  EXPECT_DOUBLE_EQ(all.getMean(), 5.0);
+  EXPECT_DOUBLE_EQ(all.getVariance(), 32.0 / 7.0);
+  EXPECT_EQ(all.getMin(), 2.0);
+  EXPECT_EQ(all.getMax(), 9.0);
+
+  first.merge(second);
+  EXPECT_EQ(first.getCount(), 8);
+  EXPECT_DOUBLE_EQ(first.getMean(), all.getMean());
+  EXPECT_DOUBLE_EQ(first.getVariance(), all.getVariance());
+  EXPECT_EQ(first.getMin(), 2.0);
+  EXPECT_EQ(first.getMax(), 9.0);
+
+  RunningStatistics empty;
+  empty.merge(all);
+  EXPECT_DOUBLE_EQ(empty.getMean(), 5.0);
+  EXPECT_EQ(empty.getCount(), 8);
+}
+
+}  // namespace
@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include "sbmlsim/SBMLSim.h"
+#include "sbmlsim/internal/system/SBMLSystem.h"
+#include "TestModelUtil.h"
+
+// count every heap allocation made by the process
+static unsigned long long allocationCount = 0;
+
+void *operator new(std::size_t size) {
+  ++allocationCount;
+  void *p = std::malloc(size == 0 ? 1 : size);
+  if (p == NULL) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void *p) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+class SBMLSystemTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    //
+    // c = 2, A = 10, B = 4 (amounts), k = 0.5
+    // R1: A -> 2 B  (k * A * c)
+    // R2: B ->      (k * B)
+    //
+    document = TestModelUtil::createDocument(2.0);
+    Model *model = document->getModel();
+    TestModelUtil::createSpecies(model, "A", 10.0, false);
+    TestModelUtil::createSpecies(model, "B", 4.0, false);
+    TestModelUtil::createParameter(model, "k", 0.5);
+    Reaction *r1 = TestModelUtil::createReaction(model, "R1", {"A"}, {}, "k * A * c");
+    TestModelUtil::createSpeciesReference(r1->createProduct(), "B", 2.0);
+    TestModelUtil::createReaction(model, "R2", {"B"}, {}, "k * B");
+
+    modelWrapper = new ModelWrapper(model);
+  }
+
+  virtual void TearDown() {
+    delete modelWrapper;
+    delete document;
+  }
+
+  SBMLDocument *document;
+  ModelWrapper *modelWrapper;
+};
+
+TEST_F(SBMLSystemTest, derivative) {
+  SBMLSystem system(modelWrapper);
+  auto x = system.getInitialState();
+  SBMLSystem::state dxdt(x.size());
+  system(x, dxdt, 0.0);
+
+  EXPECT_DOUBLE_EQ(dxdt[system.getStateIndexForVariable("A")], -5.0);
+  EXPECT_DOUBLE_EQ(dxdt[system.getStateIndexForVariable("B")], 9.0);
+}
+
+TEST_F(SBMLSystemTest, derivativeOnRawBuffers) {
+  SBMLSystem system(modelWrapper);
+  auto x = system.getInitialState();
+  std::vector<double> y(x.begin(), x.end());
+  std::vector<double> dydt(y.size());
+  system(y.data(), dydt.data(), 0.0);
+
+  EXPECT_DOUBLE_EQ(dydt[system.getStateIndexForVariable("A")], -5.0);
+  EXPECT_DOUBLE_EQ(dydt[system.getStateIndexForVariable("B")], 9.0);
+}
+
+TEST_F(SBMLSystemTest, boundaryCondition) {
+  document->getModel()->getSpecies("B")->setBoundaryCondition(true);
+  ModelWrapper wrapper(document->getModel());
+  SBMLSystem system(&wrapper);
+  auto x = system.getInitialState();
+  SBMLSystem::state dxdt(x.size());
+  system(x, dxdt, 0.0);
+
+  EXPECT_DOUBLE_EQ(dxdt[system.getStateIndexForVariable("A")], -5.0);
+  EXPECT_DOUBLE_EQ(dxdt[system.getStateIndexForVariable("B")], 0.0);
+}
+
+TEST_F(SBMLSystemTest, assignmentRuleOrder) {
+  // listed in reverse dependency order
+  Model *model = document->getModel();
+  TestModelUtil::createAssignmentRule(model, "r3", "r2 + 1");
+  TestModelUtil::createAssignmentRule(model, "r2", "r1 * 2");
+  TestModelUtil::createAssignmentRule(model, "r1", "k + A");
+  ModelWrapper wrapper(model);
+  SBMLSystem system(&wrapper);
+  auto targets = system.createOutputTargetsFromOutputFields({OutputField("r3", OutputType::AMOUNT)});
+  auto x = system.getInitialState();
+  system.handleAssignmentRule(x, 0.0);
+
+  EXPECT_DOUBLE_EQ(system.getParameterValue(targets[0].getStateIndex()), 12.0);  // A is a concentration (10 / 2)
+}
+
+TEST_F(SBMLSystemTest, unobservedAssignmentRule) {
+  Model *model = document->getModel();
+  TestModelUtil::createAssignmentRule(model, "r1", "k + A");
+  ModelWrapper wrapper(model);
+  SBMLSystem system(&wrapper);
+  auto x = system.getInitialState();
+  system.handleAssignmentRule(x, 0.0);
+
+  // nothing references r1, so it is never evaluated
+  auto targets = system.createOutputTargetsFromOutputFields({OutputField("r1", OutputType::AMOUNT)});
+  EXPECT_DOUBLE_EQ(system.getParameterValue(targets[0].getStateIndex()), 0.0);
+  system.handleAssignmentRule(x, 0.0);
+  EXPECT_DOUBLE_EQ(system.getParameterValue(targets[0].getStateIndex()), 5.5);
+}
+
+TEST_F(SBMLSystemTest, assignmentRuleInDerivative) {
+  // R3: -> B (r1), r1 = A * 2
+  Model *model = document->getModel();
+  TestModelUtil::createAssignmentRule(model, "r1", "A * 2");
+  TestModelUtil::createReaction(model, "R3", {}, {"B"}, "r1");
+  ModelWrapper wrapper(model);
+  SBMLSystem system(&wrapper);
+  auto x = system.getInitialState();
+  SBMLSystem::state dxdt(x.size());
+  auto a = system.getStateIndexForVariable("A");
+  auto b = system.getStateIndexForVariable("B");
+
+  system(x, dxdt, 0.0);
+  EXPECT_DOUBLE_EQ(dxdt[b], 9.0 + 10.0);
+
+  // r1 follows the state within every RHS call
+  x[a] = 20.0;
+  system(x, dxdt, 0.0);
+  EXPECT_DOUBLE_EQ(dxdt[b], 19.0 + 20.0);
+}
+
+TEST_F(SBMLSystemTest, cyclicAssignmentRules) {
+  Model *model = document->getModel();
+  TestModelUtil::createAssignmentRule(model, "r1", "r2 + 1");
+  TestModelUtil::createAssignmentRule(model, "r2", "r1 * 2");
+  ModelWrapper wrapper(model);
+  EXPECT_THROW(SBMLSystem system(&wrapper), std::runtime_error);
+}
+
+TEST_F(SBMLSystemTest, jacobian) {
+  SBMLSystem system(modelWrapper);
+  auto jacobi = system.createJacobi();
+  auto x = system.getInitialState();
+  ublas::matrix<double> J(x.size(), x.size());
+  SBMLSystem::state dfdt(x.size());
+  jacobi(x, J, 0.0, dfdt);
+  auto a = system.getStateIndexForVariable("A");
+  auto b = system.getStateIndexForVariable("B");
+
+  // v1 = k * (A / c) * c, v2 = k * (B / c)
+  EXPECT_DOUBLE_EQ(J(a, a), -0.5);
+  EXPECT_DOUBLE_EQ(J(a, b), 0.0);
+  EXPECT_DOUBLE_EQ(J(b, a), 1.0);
+  EXPECT_DOUBLE_EQ(J(b, b), -0.25);
+  EXPECT_DOUBLE_EQ(dfdt[a], 0.0);
+  EXPECT_DOUBLE_EQ(dfdt[b], 0.0);
+}
+
+TEST_F(SBMLSystemTest, jacobianMatchesFiniteDifferences) {
+  // R3: -> A (r1 * sin(time)), r1 = A * B
+  Model *model = document->getModel();
+  TestModelUtil::createAssignmentRule(model, "r1", "A * B");
+  TestModelUtil::createReaction(model, "R3", {}, {"A"}, "r1 * sin(time)");
+  ModelWrapper wrapper(model);
+  SBMLSystem system(&wrapper);
+  auto jacobi = system.createJacobi();
+  auto x = system.getInitialState();
+  auto n = x.size();
+  double t = 0.3;
+  ublas::matrix<double> J(n, n);
+  SBMLSystem::state dfdt(n);
+  jacobi(x, J, t, dfdt);
+
+  double h = 1e-6;
+  SBMLSystem::state f0(n), f1(n);
+  system(x, f0, t);
+  for (unsigned int j = 0; j < n; j++) {
+    auto xh = x;
+    xh[j] += h;
+    system(xh, f1, t);
+    for (unsigned int i = 0; i < n; i++) {
+      EXPECT_NEAR(J(i, j), (f1[i] - f0[i]) / h, 1e-4);
+    }
+  }
+  system(x, f1, t + h);
+  for (unsigned int i = 0; i < n; i++) {
+    EXPECT_NEAR(dfdt[i], (f1[i] - f0[i]) / h, 1e-4);
+  }
+}
+
+TEST_F(SBMLSystemTest, dualJacobian) {
+  // R3: -> A (r1 * sin(time)), r1 = A * B
+  Model *model = document->getModel();
+  TestModelUtil::createAssignmentRule(model, "r1", "A * B");
+  TestModelUtil::createReaction(model, "R3", {}, {"A"}, "r1 * sin(time)");
+  ModelWrapper wrapper(model);
+  SBMLSystem system(&wrapper);
+  auto symbolic = system.createJacobi();
+  auto dual = system.createDualJacobi();
+  auto x = system.getInitialState();
+  auto n = x.size();
+  ublas::matrix<double> expectedJ(n, n), J(n, n);
+  SBMLSystem::state expectedDfdt(n), dfdt(n);
+  symbolic(x, expectedJ, 0.3, expectedDfdt);
+  dual(x, J, 0.3, dfdt);
+
+  for (unsigned int i = 0; i < n; i++) {
+    for (unsigned int j = 0; j < n; j++) {
+      EXPECT_NEAR(J(i, j), expectedJ(i, j), 1e-12);
+    }
+    EXPECT_NEAR(dfdt[i], expectedDfdt[i], 1e-12);
+  }
+}
+
+TEST_F(SBMLSystemTest, parameterSensitivity) {
+  SBMLSystem system(modelWrapper);
+  auto x = system.getInitialState();
+  SBMLSystem::state dx(x.size(), 0.0);
+  SBMLSystem::state jv(x.size());
+  auto targets = system.createOutputTargetsFromOutputFields({OutputField("k", OutputType::AMOUNT)});
+  std::vector<double> dp(system.getParameterValues().size(), 0.0);
+  dp[targets[0].getStateIndex()] = 1.0;
+  system.directionalDerivative(x, dx, dp.data(), 0.0, 0.0, jv);
+
+  // df/dk
+  EXPECT_DOUBLE_EQ(jv[system.getStateIndexForVariable("A")], -10.0);
+  EXPECT_DOUBLE_EQ(jv[system.getStateIndexForVariable("B")], 18.0);
+}
+
+TEST_F(SBMLSystemTest, stateExcludesParameters) {
+  SBMLSystem system(modelWrapper);
+  EXPECT_EQ(system.getInitialState().size(), 2);  // A and B; k and c are in the parameter block
+}
+
+TEST_F(SBMLSystemTest, derivativeDoesNotAllocate) {
+  SBMLSystem system(modelWrapper);
+  auto x = system.getInitialState();
+  SBMLSystem::state dxdt(x.size());
+
+  auto before = allocationCount;
+  for (auto i = 0; i < 100; i++) {
+    system(x, dxdt, 0.1 * i);
+  }
+  EXPECT_EQ(allocationCount, before);
+}
+
+}  // namespace
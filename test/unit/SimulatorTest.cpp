@@ -0,0 +1,278 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "sbmlsim/Simulator.h"
+#include "TestModelUtil.h"
+
+namespace {
+
+const IntegratorType INTEGRATORS[] = {
+    IntegratorType::RUNGE_KUTTA_4, IntegratorType::RUNGE_KUTTA_DOPRI5, IntegratorType::RUNGE_KUTTA_FEHLBERG78,
+    IntegratorType::ROSENBROCK4, IntegratorType::LSODA, IntegratorType::AUTO, IntegratorType::GILLESPIE_DIRECT,
+    IntegratorType::GILLESPIE_NEXT_REACTION, IntegratorType::GILLESPIE_COMPOSITION_REJECTION,
+    IntegratorType::TAU_LEAPING};
+
+class SimulatorTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    // S -> P at rate k * S, with an event resetting S when P passes 5
+    document = TestModelUtil::createDocument();
+    Model *model = document->getModel();
+    TestModelUtil::createSpecies(model, "S", 10.0);
+    TestModelUtil::createSpecies(model, "P", 0.0);
+    TestModelUtil::createParameter(model, "k", 0.5);
+    kineticLaw = TestModelUtil::createReaction(model, "R", {"S"}, {"P"}, "k * S")->getKineticLaw();
+    TestModelUtil::createEvent(model, "reset", "P > 5", {{"S", "10"}});
+  }
+
+  virtual void TearDown() {
+    delete document;
+  }
+
+  std::vector<double> simulate(const Simulator &simulator, const RunConfiguration &conf,
+                               const std::vector<Simulator::Override> &overrides = {}) {
+    std::vector<double> values;
+    simulator.run(conf, overrides, [&values](double t, const std::vector<double> &output) {
+      values.push_back(t);
+      values.insert(values.end(), output.begin(), output.end());
+    });
+    return values;
+  }
+
+  SBMLDocument *document;
+  KineticLaw *kineticLaw;
+};
+
+TEST_F(SimulatorTest, runTwice) {
+  Simulator simulator(document);
+  delete document;  // the simulator keeps a copy of the model
+  document = NULL;
+  RunConfiguration conf(10.0, 1.0, {OutputField("S", OutputType::AMOUNT), OutputField("P", OutputType::AMOUNT)});
+
+  auto first = simulate(simulator, conf);
+  auto second = simulate(simulator, conf);
+  ASSERT_EQ(first.size(), 11 * 3);
+  EXPECT_EQ(first, second);
+  EXPECT_DOUBLE_EQ(first[1], 10.0);
+  EXPECT_NEAR(first[3 + 1], 10.0 * std::exp(-0.5), 1e-4);
+  EXPECT_GT(first[10 * 3 + 2], 10.0);  // S was reset once
+}
+
+TEST_F(SimulatorTest, concurrentRuns) {
+  Simulator simulator(document);
+  RunConfiguration conf(10.0, 0.5, {OutputField("S", OutputType::AMOUNT), OutputField("P", OutputType::AMOUNT)});
+  auto expected = simulate(simulator, conf);
+
+  std::vector<std::vector<double> > results(4);
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < 4; i++) {
+    threads.emplace_back([&, i]() {
+      Simulator copy(simulator);
+      for (auto j = 0; j < 10; j++) {
+        results[i] = simulate(copy, conf);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (auto &result : results) {
+    EXPECT_EQ(result, expected);
+  }
+}
+
+TEST_F(SimulatorTest, eventAtStartTime) {
+  // a trigger holding at the start time fires there with every integrator, unless its initial value is true
+  Model *model = document->getModel();
+  Trigger *trigger = TestModelUtil::createEvent(model, "start", "time >= 0", {{"P", "1"}})->getTrigger();
+  for (auto initialValue : {false, true}) {
+    trigger->setInitialValue(initialValue);
+    Simulator simulator(document);
+    for (auto integrator : INTEGRATORS) {
+      RunConfiguration conf(1.0, 0.5, {OutputField("P", OutputType::AMOUNT)});
+      conf.setIntegrator(integrator);
+      auto values = simulate(simulator, conf);
+      ASSERT_EQ(values.size(), 3 * 2);
+      EXPECT_EQ(values[1], initialValue ? 0.0 : 1.0) << static_cast<int>(integrator);
+    }
+  }
+}
+
+TEST_F(SimulatorTest, simultaneousEvents) {
+  // two events at the same time swap A and B: all assignments use the values from before either executes
+  Model *model = document->getModel();
+  TestModelUtil::createSpecies(model, "A", 1.0);
+  TestModelUtil::createSpecies(model, "B", 2.0);
+  TestModelUtil::createEvent(model, "first", "time >= 0.25", {{"A", "B"}});
+  TestModelUtil::createEvent(model, "second", "time >= 0.25", {{"B", "A"}});
+  Simulator simulator(document);
+  for (auto integrator : INTEGRATORS) {
+    RunConfiguration conf(1.0, 0.5, {OutputField("A", OutputType::AMOUNT), OutputField("B", OutputType::AMOUNT)});
+    conf.setIntegrator(integrator);
+    auto values = simulate(simulator, conf);
+    ASSERT_EQ(values.size(), 3 * 3);
+    EXPECT_EQ(values[3 * 2 + 1], 2.0) << static_cast<int>(integrator);
+    EXPECT_EQ(values[3 * 2 + 2], 1.0) << static_cast<int>(integrator);
+  }
+}
+
+TEST_F(SimulatorTest, cascadingEvents) {
+  // the assignment of one event makes the trigger of the next one true at the same time
+  Model *model = document->getModel();
+  TestModelUtil::createSpecies(model, "A", 0.0);
+  TestModelUtil::createSpecies(model, "B", 0.0);
+  TestModelUtil::createSpecies(model, "C", 0.0);
+  TestModelUtil::createEvent(model, "first", "time >= 0.25", {{"A", "1"}});
+  TestModelUtil::createEvent(model, "second", "A > 0.5", {{"B", "A + 1"}});
+  TestModelUtil::createEvent(model, "third", "B > 1.5", {{"C", "B + 1"}});
+  Simulator simulator(document);
+  for (auto integrator : INTEGRATORS) {
+    RunConfiguration conf(1.0, 0.5, {OutputField("A", OutputType::AMOUNT), OutputField("B", OutputType::AMOUNT),
+                                     OutputField("C", OutputType::AMOUNT)});
+    conf.setIntegrator(integrator);
+    auto values = simulate(simulator, conf);
+    ASSERT_EQ(values.size(), 3 * 4);
+    EXPECT_EQ(values[4 * 1 + 1], 1.0) << static_cast<int>(integrator);
+    EXPECT_EQ(values[4 * 1 + 2], 2.0) << static_cast<int>(integrator);
+    EXPECT_EQ(values[4 * 1 + 3], 3.0) << static_cast<int>(integrator);
+  }
+
+  // events that keep triggering each other at one time
+  TestModelUtil::createEvent(model, "loop", "C > 2.5", {{"C", "0"}});
+  TestModelUtil::createEvent(model, "loopBack", "C < 0.5", {{"C", "3"}});
+  Simulator looping(document);
+  RunConfiguration conf(1.0, 0.5, {OutputField("C", OutputType::AMOUNT)});
+  EXPECT_THROW(simulate(looping, conf), std::exception);
+}
+
+TEST_F(SimulatorTest, timeEventWhileNothingFires) {
+  // no propensity until the event at time >= 0.25 sets P; stochastic runs see it at the output point t = 0.5
+  TestModelUtil::setMath(kineticLaw, "k * S * P");
+  TestModelUtil::createEvent(document->getModel(), "start", "time >= 0.25", {{"P", "1"}});
+  Simulator simulator(document);
+  for (auto integrator : INTEGRATORS) {
+    RunConfiguration conf(2.0, 0.5, {OutputField("P", OutputType::AMOUNT)});
+    conf.setIntegrator(integrator);
+    auto values = simulate(simulator, conf);
+    ASSERT_EQ(values.size(), 5 * 2);
+    EXPECT_EQ(values[1], 0.0) << static_cast<int>(integrator);
+    EXPECT_GE(values[2 * 1 + 1], 1.0) << static_cast<int>(integrator);
+    EXPECT_GT(values[2 * 4 + 1], 1.0) << static_cast<int>(integrator);
+  }
+}
+
+TEST_F(SimulatorTest, ensemble) {
+  Simulator simulator(document);
+  RunConfiguration conf(5.0, 0.5, {OutputField("S", OutputType::AMOUNT), OutputField("P", OutputType::AMOUNT)});
+  conf.setIntegrator(IntegratorType::GILLESPIE_DIRECT);
+  conf.setSeed(7);
+
+  // trajectory k is the same for any number of threads
+  std::vector<std::vector<double> > results[2];
+  for (auto run = 0; run < 2; run++) {
+    std::mutex mutex;
+    results[run].resize(8);
+    auto numFirings = simulator.ensemble(conf, 8, run == 0 ? 1 : 3, [&](unsigned long trajectory, double t,
+                                                                        const std::vector<double> &output) {
+      std::lock_guard<std::mutex> lock(mutex);
+      results[run][trajectory].push_back(t);
+      results[run][trajectory].insert(results[run][trajectory].end(), output.begin(), output.end());
+    });
+    EXPECT_GT(numFirings, 0);
+  }
+  for (auto trajectory = 0; trajectory < 8; trajectory++) {
+    ASSERT_EQ(results[0][trajectory].size(), 11 * 3);
+    EXPECT_EQ(results[0][trajectory][1], 10.0);
+    EXPECT_EQ(results[0][trajectory], results[1][trajectory]);
+  }
+  EXPECT_NE(results[0][0], results[0][1]);
+
+  conf.setIntegrator(IntegratorType::RUNGE_KUTTA_4);
+  EXPECT_THROW(simulator.ensemble(conf, 8, 2, [](unsigned long, double, const std::vector<double> &) {}),
+               std::exception);
+}
+
+TEST_F(SimulatorTest, overrides) {
+  Simulator simulator(document);
+  RunConfiguration conf(1.0, 1.0, {OutputField("S", OutputType::AMOUNT)});
+  auto k = simulator.getSlot("k");
+  auto s = simulator.getSlot("S");
+  EXPECT_NE(k, s);
+  EXPECT_THROW(simulator.getSlot("unknown"), std::exception);
+
+  auto values = simulate(simulator, conf, {{k, 1.0}, {s, 4.0}});
+  EXPECT_NEAR(values[2 + 1], 4.0 * std::exp(-1.0), 1e-4);
+  // overrides only last for their run
+  values = simulate(simulator, conf, {});
+  EXPECT_NEAR(values[2 + 1], 10.0 * std::exp(-0.5), 1e-4);
+}
+
+TEST_F(SimulatorTest, localParameters) {
+  // a local k shadows the global one and has a slot of its own
+  auto localParameter = kineticLaw->createLocalParameter();
+  localParameter->setId("k");
+  localParameter->setValue(0.1);
+  Simulator simulator(document);
+  RunConfiguration conf(1.0, 1.0, {OutputField("S", OutputType::AMOUNT)});
+
+  auto values = simulate(simulator, conf, {});
+  EXPECT_NEAR(values[2 + 1], 10.0 * std::exp(-0.1), 1e-4);
+  values = simulate(simulator, conf, {{simulator.getSlot("R.k"), 0.2}});
+  EXPECT_NEAR(values[2 + 1], 10.0 * std::exp(-0.2), 1e-4);
+  values = simulate(simulator, conf, {{simulator.getSlot("k"), 0.2}});
+  EXPECT_NEAR(values[2 + 1], 10.0 * std::exp(-0.1), 1e-4);
+}
+
+TEST_F(SimulatorTest, sweep) {
+  Simulator simulator(document);
+  RunConfiguration conf(2.0, 0.5, {OutputField("S", OutputType::AMOUNT), OutputField("P", OutputType::AMOUNT)});
+  std::vector<unsigned int> slots = {simulator.getSlot("k"), simulator.getSlot("S")};
+  std::vector<double> values;
+  for (auto i = 0; i < 20; i++) {
+    values.push_back(0.1 * (i + 1));
+    values.push_back(static_cast<double>(i));
+  }
+  auto numPoints = Simulator::getNumOutputPoints(conf);
+  ASSERT_EQ(numPoints, 5);
+
+  std::vector<double> results(20 * numPoints * 2);
+  EXPECT_EQ(simulator.sweep(conf, slots, values, 3, results.data()), 20);
+  for (auto row = 0; row < 20; row++) {
+    auto expected = simulate(simulator, conf, {{slots[0], values[2 * row]}, {slots[1], values[2 * row + 1]}});
+    for (unsigned int point = 0; point < numPoints; point++) {
+      EXPECT_EQ(results[(row * numPoints + point) * 2], expected[point * 3 + 1]);
+      EXPECT_EQ(results[(row * numPoints + point) * 2 + 1], expected[point * 3 + 2]);
+    }
+  }
+  values.pop_back();
+  EXPECT_THROW(simulator.sweep(conf, slots, values, 3, results.data()), std::exception);
+}
+
+TEST_F(SimulatorTest, sweepBatch) {
+  // without the event, RK4 rows run in lockstep batches; each row must match a run of its own
+  delete document->getModel()->removeEvent(0);
+  Simulator simulator(document);
+  RunConfiguration conf(2.0, 0.1, {OutputField("S", OutputType::AMOUNT), OutputField("P", OutputType::AMOUNT)});
+  conf.setIntegrator(IntegratorType::RUNGE_KUTTA_4);
+  std::vector<unsigned int> slots = {simulator.getSlot("k")};
+  std::vector<double> values;
+  for (auto i = 0; i < 20; i++) {
+    values.push_back(0.1 * (i + 1));
+  }
+  auto numPoints = Simulator::getNumOutputPoints(conf);
+
+  std::vector<double> results(20 * numPoints * 2);
+  simulator.sweep(conf, slots, values, 2, results.data());
+  for (auto row = 0; row < 20; row++) {
+    auto expected = simulate(simulator, conf, {{slots[0], values[row]}});
+    ASSERT_EQ(expected.size(), numPoints * 3);
+    for (unsigned int point = 0; point < numPoints; point++) {
+      EXPECT_NEAR(results[(row * numPoints + point) * 2], expected[point * 3 + 1], 1e-12);
+      EXPECT_NEAR(results[(row * numPoints + point) * 2 + 1], expected[point * 3 + 2], 1e-12);
+    }
+  }
+}
+
+}  // namespace
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include "sbmlsim/internal/system/StoichiometryMatrix.h"
+
+namespace {
+
+//
+// R0: A -> 2 B
+// R1: B + B -> C
+// R2: A -> A + C (A is a catalyst)
+//
+StoichiometryMatrix createMatrix() {
+  StoichiometryMatrix matrix(3, 3);
+  matrix.add(0, 0, -1.0);
+  matrix.add(1, 0, 2.0);
+  matrix.add(1, 1, -1.0);
+  matrix.add(1, 1, -1.0);
+  matrix.add(2, 1, 1.0);
+  matrix.add(0, 2, -1.0);
+  matrix.add(0, 2, 1.0);
+  matrix.add(2, 2, 1.0);
+  matrix.compress();
+  return matrix;
+}
+
+TEST(StoichiometryMatrixTest, compress) {
+  auto matrix = createMatrix();
+  EXPECT_EQ(matrix.getNumNonZeros(), 5);  // duplicates merged, zeros dropped
+
+  // column 1 (R1): B -2, C +1
+  auto &pointers = matrix.getColumnPointers();
+  ASSERT_EQ(pointers[2] - pointers[1], 2);
+  EXPECT_EQ(matrix.getRowIndices()[pointers[1]], 1);
+  EXPECT_DOUBLE_EQ(matrix.getColumnValues()[pointers[1]], -2.0);
+  EXPECT_EQ(matrix.getRowIndices()[pointers[1] + 1], 2);
+  EXPECT_DOUBLE_EQ(matrix.getColumnValues()[pointers[1] + 1], 1.0);
+}
+
+TEST(StoichiometryMatrixTest, multiply) {
+  auto matrix = createMatrix();
+  double v[] = {1.0, 2.0, 3.0};
+  double y[] = {-1.0, -1.0, -1.0};
+  matrix.multiply(v, y);
+  EXPECT_DOUBLE_EQ(y[0], -1.0);
+  EXPECT_DOUBLE_EQ(y[1], -2.0);
+  EXPECT_DOUBLE_EQ(y[2], 5.0);
+}
+
+}  // namespace
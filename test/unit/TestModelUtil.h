@@ -0,0 +1,108 @@
+#ifndef TEST_UNIT_TESTMODELUTIL_H_
+#define TEST_UNIT_TESTMODELUTIL_H_
+
+#include <sbml/SBMLTypes.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Building blocks for the models of the unit tests. Everything lives in one
+ * constant compartment "c"; reactions are irreversible and events persistent,
+ * with values from their trigger time.
+ */
+class TestModelUtil {
+ public:
+  // a level 3 document with a model and the compartment "c"
+  static SBMLDocument *createDocument(double compartmentSize = 1.0) {
+    SBMLDocument *document = new SBMLDocument(3, 1);
+    Model *model = document->createModel();
+    Compartment *c = model->createCompartment();
+    c->setId("c");
+    c->setSize(compartmentSize);
+    c->setConstant(true);
+    return document;
+  }
+
+  static Species *createSpecies(Model *model, const std::string &id, double amount,
+                                bool hasOnlySubstanceUnits = true) {
+    Species *species = model->createSpecies();
+    species->setId(id);
+    species->setCompartment("c");
+    species->setInitialAmount(amount);
+    species->setHasOnlySubstanceUnits(hasOnlySubstanceUnits);
+    species->setBoundaryCondition(false);
+    species->setConstant(false);
+    return species;
+  }
+
+  static Parameter *createParameter(Model *model, const std::string &id, double value, bool constant = true) {
+    Parameter *parameter = model->createParameter();
+    parameter->setId(id);
+    parameter->setValue(value);
+    parameter->setConstant(constant);
+    return parameter;
+  }
+
+  static void createSpeciesReference(SpeciesReference *speciesReference, const std::string &speciesId,
+                                     double stoichiometry = 1.0) {
+    speciesReference->setSpecies(speciesId);
+    speciesReference->setStoichiometry(stoichiometry);
+    speciesReference->setConstant(true);
+  }
+
+  // every reactant and product with stoichiometry 1 (list a species twice for 2)
+  static Reaction *createReaction(Model *model, const std::string &id, const std::vector<std::string> &reactants,
+                                  const std::vector<std::string> &products, const char *formula) {
+    Reaction *reaction = model->createReaction();
+    reaction->setId(id);
+    reaction->setReversible(false);
+    for (auto &reactant : reactants) {
+      createSpeciesReference(reaction->createReactant(), reactant);
+    }
+    for (auto &product : products) {
+      createSpeciesReference(reaction->createProduct(), product);
+    }
+    setMath(reaction->createKineticLaw(), formula);
+    return reaction;
+  }
+
+  // a non-constant parameter defined by the rule
+  static void createAssignmentRule(Model *model, const std::string &variable, const char *formula) {
+    createParameter(model, variable, 0.0, false);
+    AssignmentRule *rule = model->createAssignmentRule();
+    rule->setVariable(variable);
+    setMath(rule, formula);
+  }
+
+  // assignments as (variable, formula)
+  static Event *createEvent(Model *model, const std::string &id, const char *trigger,
+                            const std::vector<std::pair<std::string, std::string> > &assignments) {
+    Event *event = model->createEvent();
+    event->setId(id);
+    event->setUseValuesFromTriggerTime(true);
+    Trigger *eventTrigger = event->createTrigger();
+    eventTrigger->setInitialValue(false);
+    eventTrigger->setPersistent(true);
+    setMath(eventTrigger, trigger);
+    for (auto &assignment : assignments) {
+      EventAssignment *eventAssignment = event->createEventAssignment();
+      eventAssignment->setVariable(assignment.first);
+      setMath(eventAssignment, assignment.second.c_str());
+    }
+    return event;
+  }
+
+  template<class T>
+  static void setMath(T *element, const char *formula) {
+    ASTNode *math = SBML_parseL3Formula(formula);
+    element->setMath(math);
+    delete math;
+  }
+
+ private:
+  TestModelUtil() {}
+  ~TestModelUtil() {}
+};
+
+#endif /* TEST_UNIT_TESTMODELUTIL_H_ */
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "sbmlsim/internal/parallel/WorkStealingScheduler.h"
+
+namespace {
+
+TEST(WorkStealingSchedulerTest, everyTaskOnce) {
+  WorkStealingScheduler scheduler(4);
+  EXPECT_EQ(scheduler.getNumThreads(), 4);
+  std::vector<std::atomic<int> > counts(1000);
+  for (auto &count : counts) {
+    count = 0;
+  }
+  scheduler.run(counts.size(), [&counts](unsigned int worker, unsigned long index) {
+    EXPECT_LT(worker, 4);
+    counts[index]++;
+  });
+  for (auto &count : counts) {
+    EXPECT_EQ(count.load(), 1);
+  }
+  scheduler.run(0, [](unsigned int, unsigned long) { FAIL(); });
+}
+
+TEST(WorkStealingSchedulerTest, stealsFromSlowWorker) {
+  // the first block is slow; the other workers finish theirs and take over its tasks
+  WorkStealingScheduler scheduler(4);
+  std::vector<unsigned int> workers(40);
+  auto numSteals = scheduler.run(workers.size(), [&workers](unsigned int worker, unsigned long index) {
+    if (index < 10) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    workers[index] = worker;
+  });
+  EXPECT_GT(numSteals, 0);
+  auto numRunByOthers = 0;
+  for (auto index = 0; index < 10; index++) {
+    numRunByOthers += workers[index] != 0 ? 1 : 0;
+  }
+  EXPECT_GT(numRunByOthers, 0);
+}
+
+TEST(WorkStealingSchedulerTest, rethrows) {
+  WorkStealingScheduler scheduler(3);
+  EXPECT_THROW(scheduler.run(100, [](unsigned int, unsigned long index) {
+    if (index == 42) {
+      throw std::runtime_error("task failed");
+    }
+  }), std::runtime_error);
+}
+
+}  // namespace